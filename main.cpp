@@ -50,7 +50,13 @@ int main(int argc, char* argv[]) {
 
 	auto core = Core::CoreManager();
 	core.Initialize();
-	core.getRenderer()->AddMesh(meshA);
+	auto meshId = core.getRenderer()->AddMesh(meshA);
+
+	auto world = core.getWorld();
+	auto cube = world->createNewEntity().value();
+	world->addComponent<Core::TransformComponent>(cube);
+	world->addComponent<Core::MeshRendererComponent>(cube);
+	world->getComponent<Core::MeshRendererComponent>(cube).value()->meshId = meshId;
 	core.Run();
 
 	core.Shutdown();
@@ -9,6 +9,7 @@
 #include <vector>
 #include <string>
 #include <sstream>
+#include <functional>
 #include "JarRenderer.hpp"
 
 namespace Core::Window {
@@ -67,6 +68,9 @@ namespace Core::Window {
 
 			virtual void Update() = 0;
 
+			/// Replace the default drawing of all meshes by a function that draws each frame with the renderer.
+			virtual void SetRenderCallback(std::function<void(Graphics::JarRenderer&)> callback) = 0;
+
 			virtual void Shutdown() = 0;
 
 			[[nodiscard]] virtual std::shared_ptr<Graphics::JarRenderer> getRenderer() const = 0;
@@ -110,11 +110,20 @@ namespace Core::Window {
 			}
 
 
-			if (!m_resizeOccurred && !m_pendingResize)
-				renderer->Render();
+			if (!m_resizeOccurred && !m_pendingResize) {
+				if (renderCallback) {
+					renderCallback(*renderer);
+				} else {
+					renderer->Render();
+				}
+			}
 		}
 	}
 
+	void SdlWindow::SetRenderCallback(std::function<void(Graphics::JarRenderer&)> callback) {
+		renderCallback = std::move(callback);
+	}
+
 	void SdlWindow::Shutdown() {
 		renderer->Shutdown();
 		SDL_Quit();
@@ -32,6 +32,8 @@ namespace Core::Window {
 
 			void Update() override;
 
+			void SetRenderCallback(std::function<void(Graphics::JarRenderer&)> callback) override;
+
 			void Shutdown() override;
 
 			std::vector<DisplayOpts> GetAvailableDisplayOpts() override;
@@ -54,7 +56,7 @@ namespace Core::Window {
 			bool m_resizeOccurred;
 
 			std::shared_ptr<Graphics::JarRenderer> renderer;
-
+			std::function<void(Graphics::JarRenderer&)> renderCallback;
 
 			void HandleKeyDownEvent(const SDL_Event& event);
 			static std::vector<DisplayOpts> getAvailableDisplayOpts();
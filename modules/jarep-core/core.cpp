@@ -23,11 +23,30 @@ namespace Core {
 		renderStepDescriptor->m_stencilTestEnabled = true;
 		renderStepDescriptor->m_multisamplingCount = 64;
 		window->getRenderer()->AddRenderStep(std::move(renderStepDescriptor));
+
+		world = std::make_shared<World>();
+		window->SetRenderCallback([this](Graphics::JarRenderer& renderer) {
+			renderExtraction.Render(renderer);
+		});
 	}
 
 	void CoreManager::Run() {
 		std::cout << "Run Core" << std::endl;
+		simulationRunning = true;
+		simulationThread = std::thread(&CoreManager::simulate, this);
 		window->Update();
+
+		simulationRunning = false;
+		renderExtraction.Close();
+		simulationThread.join();
+	}
+
+	void CoreManager::simulate() {
+		// The next frame is simulated while the renderer draws the last extracted one.
+		while (simulationRunning) {
+			world->tick();
+			if (!renderExtraction.Extract(*world)) break;
+		}
 	}
 
 	void CoreManager::Shutdown() {
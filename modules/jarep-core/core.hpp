@@ -5,13 +5,16 @@
 #ifndef JAREP_CORE_HPP
 #define JAREP_CORE_HPP
 
+#include <atomic>
 #include <iostream>
 #include <memory>
+#include <thread>
 
 #include "Window/IWindow.hpp"
 #include "Window/sdlwindow.hpp"
 #include "JarRenderer.hpp"
 #include "JarRenderStep.hpp"
+#include "renderextraction.hpp"
 
 
 namespace Core {
@@ -29,8 +32,17 @@ namespace Core {
 
 			[[nodiscard]] std::shared_ptr<Graphics::JarRenderer> getRenderer() const { return window->getRenderer(); }
 
+			/// The world that is simulated on its own thread while the window renders the last extracted frame.
+			[[nodiscard]] std::shared_ptr<World> getWorld() const { return world; }
+
 		private:
 			std::unique_ptr<Window::IWindow> window;
+			std::shared_ptr<World> world;
+			RenderExtraction renderExtraction;
+			std::thread simulationThread;
+			std::atomic<bool> simulationRunning = false;
+
+			void simulate();
 	};
 }
 
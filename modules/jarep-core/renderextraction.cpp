@@ -0,0 +1,33 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#include "renderextraction.hpp"
+
+#include <algorithm>
+
+namespace Core {
+
+	bool RenderExtraction::Extract(World& world) {
+		auto& renderList = renderLists.getBackList();
+		world.readEachEnabled<TransformComponent, MeshRendererComponent>(
+				[&renderList](const TransformComponent&, const MeshRendererComponent& meshRenderer) {
+					renderList.push_back(Graphics::RenderItem{meshRenderer.meshId, meshRenderer.materialId});
+				});
+		std::sort(renderList.begin(), renderList.end(), [](const auto& a, const auto& b) {
+			return a.GetSortKey() < b.GetSortKey();
+		});
+		renderLists.publish();
+		return renderLists.waitUntilPickedUp();
+	}
+
+	uint64_t RenderExtraction::Render(Graphics::JarRenderer& renderer) {
+		return renderLists.read([&renderer](const std::vector<Graphics::RenderItem>& renderList) {
+			renderer.Render(renderList);
+		});
+	}
+
+	void RenderExtraction::Close() {
+		renderLists.close();
+	}
+}
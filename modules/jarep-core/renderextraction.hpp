@@ -0,0 +1,63 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_RENDEREXTRACTION_HPP
+#define JAREP_RENDEREXTRACTION_HPP
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "world.hpp"
+#include "extractionbuffer.hpp"
+#include "JarRenderer.hpp"
+#include "RenderItem.hpp"
+
+namespace Core {
+
+	/// Places an entity in the scene. Only entities with a transform are extracted, but the renderer does not apply the
+	/// matrix yet, see JarRenderer::Render.
+	class TransformComponent : public Component {
+		public:
+			glm::mat4 model = glm::mat4(1.0f);
+	};
+
+	/// Draws the entity with a mesh of the renderer.
+	class MeshRendererComponent : public Component {
+		public:
+			/// The id returned by JarRenderer::AddMesh.
+			uint32_t meshId = 0;
+			uint32_t materialId = 0;
+	};
+
+	/// Copies everything the renderer needs from a world into a packed render list, sorted by material and mesh. The
+	/// lists are double-buffered, so the simulation can extract and simulate the next frame on its own thread while the
+	/// renderer draws the last extracted frame.
+	class RenderExtraction {
+		public:
+			RenderExtraction() = default;
+
+			~RenderExtraction() = default;
+
+			/// Extract the render list of the current state of a world and hand it to the renderer. Returns once the
+			/// renderer has started drawing the list, so the simulation of the next frame runs while this one is drawn and
+			/// never gets further ahead. Must be called from the simulation thread.
+			/// \param world The world to extract. Entities with disabled transform or mesh renderer are left out.
+			/// \return False if the extraction has been closed.
+			bool Extract(World& world);
+
+			/// Draw the last extracted render list, or nothing if nothing has been extracted yet. Must be called from the
+			/// render thread.
+			/// \param renderer The renderer to draw with.
+			/// \return The amount of frames extracted before the drawn list.
+			uint64_t Render(Graphics::JarRenderer& renderer);
+
+			/// Stop waiting for the renderer, e.g. because the window has been closed.
+			void Close();
+
+		private:
+			ExtractionBuffer<Graphics::RenderItem> renderLists;
+	};
+}
+
+#endif //JAREP_RENDEREXTRACTION_HPP
@@ -0,0 +1,160 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "simulationrunner.hpp"
+
+// Runs ECS worlds at a fixed tick rate without a window or renderer and prints their tick time statistics.
+//
+// Usage: JAREP_HEADLESS [--worlds N] [--rate HZ] [--ticks N] [--entities N] [--report SECONDS]
+//   --worlds    The amount of worlds, each one ticked on its own thread. Default 1.
+//   --rate      The tick rate in ticks per second. Default 60.
+//   --ticks     The amount of ticks after which the worlds stop. Runs until interrupted if 0. Default 0.
+//   --entities  The amount of moving entities spawned in every world. Default 1000.
+//   --report    The time between two statistics reports in seconds. Default 1.
+
+namespace {
+
+	class HeadlessPosition : public Component {
+		public:
+			float x = 0.0f;
+			float y = 0.0f;
+			float z = 0.0f;
+	};
+
+	class HeadlessVelocity : public Component {
+		public:
+			float x = 1.0f;
+			float y = 0.0f;
+			float z = 0.0f;
+	};
+
+	class HeadlessMovementSystem : public System {
+		protected:
+			void update() override {
+				float deltaSeconds = std::chrono::duration<float>(getDeltaTime()).count();
+				for (const Entity entity: getEntities()) {
+					auto position = getComponent<HeadlessPosition>(entity);
+					auto velocity = getComponent<HeadlessVelocity>(entity);
+					if (!position.has_value() || !velocity.has_value()) continue;
+					position.value()->x += velocity.value()->x * deltaSeconds;
+					position.value()->y += velocity.value()->y * deltaSeconds;
+					position.value()->z += velocity.value()->z * deltaSeconds;
+				}
+			}
+	};
+
+	std::atomic<bool> interrupted = false;
+
+	void handleInterrupt(int) {
+		interrupted = true;
+	}
+
+	std::shared_ptr<World> createWorld(size_t entityCount) {
+		auto world = std::make_shared<World>();
+		for (size_t i = 0; i < entityCount; ++i) {
+			auto entity = world->createNewEntity();
+			if (!entity.has_value()) break;
+			world->addComponent<HeadlessPosition>(entity.value());
+			world->addComponent<HeadlessVelocity>(entity.value());
+		}
+
+		// Systems can only require registered components, so the system is registered after the entities exist.
+		if (entityCount > 0) {
+			world->registerSystem<HeadlessMovementSystem>({typeid(HeadlessPosition), typeid(HeadlessVelocity)});
+		}
+		return world;
+	}
+
+	void printStatistics(const std::vector<TickStatistics> &statistics) {
+		using std::chrono::duration_cast;
+		using std::chrono::microseconds;
+		for (size_t worldIndex = 0; worldIndex < statistics.size(); ++worldIndex) {
+			const auto &worldStatistics = statistics[worldIndex];
+			if (worldStatistics.tickCount == 0) continue;
+			std::cout << "World " << worldIndex
+			          << ": ticks " << worldStatistics.tickCount
+			          << ", avg " << duration_cast<microseconds>(worldStatistics.getAverageTickDuration()).count() << "us"
+			          << ", min " << duration_cast<microseconds>(worldStatistics.minTickDuration).count() << "us"
+			          << ", max " << duration_cast<microseconds>(worldStatistics.maxTickDuration).count() << "us"
+			          << ", overruns " << worldStatistics.overrunCount
+			          << ", skipped " << worldStatistics.skippedTickCount << std::endl;
+		}
+	}
+}
+
+int main(int argc, char *argv[]) {
+	size_t worldCount = 1;
+	double tickRate = 60.0;
+	uint64_t tickLimit = 0;
+	size_t entityCount = 1000;
+	double reportInterval = 1.0;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string argument = argv[i];
+		if (i + 1 >= argc) {
+			std::cerr << "Missing value for " << argument << std::endl;
+			return EXIT_FAILURE;
+		}
+		std::string value = argv[++i];
+		try {
+			if (argument == "--worlds") worldCount = std::stoul(value);
+			else if (argument == "--rate") tickRate = std::stod(value);
+			else if (argument == "--ticks") tickLimit = std::stoull(value);
+			else if (argument == "--entities") entityCount = std::stoul(value);
+			else if (argument == "--report") reportInterval = std::stod(value);
+			else {
+				std::cerr << "Unknown argument " << argument << std::endl;
+				return EXIT_FAILURE;
+			}
+		} catch (const std::exception &) {
+			std::cerr << "Invalid value " << value << " for " << argument << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+	if (worldCount == 0 || tickRate <= 0.0 || reportInterval <= 0.0) {
+		std::cerr << "Worlds, rate and report interval must be greater than zero" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	auto tickInterval = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(1.0 / tickRate));
+	auto runner = SimulationRunner(tickInterval);
+	for (size_t worldIndex = 0; worldIndex < worldCount; ++worldIndex) {
+		runner.addWorld(createWorld(entityCount));
+	}
+
+	std::signal(SIGINT, handleInterrupt);
+	std::signal(SIGTERM, handleInterrupt);
+
+	std::cout << "Running " << worldCount << " world(s) at " << tickRate << " ticks per second" << std::endl;
+	runner.start(tickLimit == 0 ? std::nullopt : std::make_optional(tickLimit));
+
+	// The statistics are reported from the main thread until every world has reached the tick limit or the process is
+	// interrupted.
+	auto reportDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>(reportInterval));
+	auto nextReportTime = std::chrono::steady_clock::now() + reportDuration;
+	while (!interrupted) {
+		auto statistics = runner.getStatistics();
+		bool finished = tickLimit != 0;
+		for (const auto &worldStatistics: statistics) {
+			if (worldStatistics.tickCount < tickLimit) finished = false;
+		}
+		if (finished) break;
+
+		if (std::chrono::steady_clock::now() >= nextReportTime) {
+			printStatistics(statistics);
+			nextReportTime += reportDuration;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	runner.stop();
+	printStatistics(runner.getStatistics());
+	return EXIT_SUCCESS;
+}
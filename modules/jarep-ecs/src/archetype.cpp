@@ -17,6 +17,16 @@ std::unique_ptr<Archetype> Archetype::createEmpty() {
 	return std::make_unique<Archetype>();
 }
 
+std::unique_ptr<Archetype> Archetype::createFromCollections(
+		std::vector<std::pair<std::type_index, std::unique_ptr<ComponentInstanceCollection>>> collections) {
+	auto instance = std::make_unique<Archetype>();
+	for (auto &typeCollection: collections) {
+		instance->componentTypeMap[typeCollection.first] = instance->componentCollections.size();
+		instance->componentCollections.push_back(std::move(typeCollection.second));
+	}
+	return instance;
+}
+
 void Archetype::removeComponentsAtEntityIndex(size_t entityIndex) {
 
 	for (const auto &componentCollection: componentCollections) {
@@ -43,5 +53,105 @@ std::optional<size_t> Archetype::migrateEntity(std::unique_ptr<Archetype> &from,
 	return std::make_optional(newEntityIndex);
 }
 
+void Archetype::vacateEntityIndex(size_t entityIndex) {
+
+	for (const auto &componentCollection: componentCollections) {
+		componentCollection->vacate(entityIndex);
+	}
+}
 
+size_t Archetype::getRowCount() const {
+	if (componentCollections.empty()) return 0;
+	return componentCollections[0]->getCollectionLength();
+}
+
+size_t Archetype::getEntityCount() const {
+	size_t rowCount = getRowCount();
+	size_t entityCount = 0;
+	for (size_t row = 0; row < rowCount; ++row) {
+		if (!componentCollections[0]->isVacant(row)) entityCount++;
+	}
+	return entityCount;
+}
+
+size_t Archetype::getRowCapacity() const {
+	if (componentCollections.empty()) return 0;
+	return componentCollections[0]->getCollectionCapacity();
+}
 
+std::vector<std::optional<size_t>> Archetype::compactRows() {
+
+	// A row is vacant if its entity migrated away. Since all collections are vacated together, the first collection is
+	// sufficient to find them.
+	size_t rowCount = getRowCount();
+	auto rowRemap = std::vector<std::optional<size_t>>(rowCount);
+	size_t nextRow = 0;
+	for (size_t row = 0; row < rowCount; ++row) {
+		if (componentCollections[0]->isVacant(row)) continue;
+		rowRemap[row] = nextRow;
+		nextRow++;
+	}
+
+	if (nextRow == rowCount) return rowRemap;
+
+	for (const auto &componentCollection: componentCollections) {
+		componentCollection->removeVacant();
+	}
+	return rowRemap;
+}
+
+std::vector<std::optional<size_t>> Archetype::reorderRows(const std::vector<size_t> &rowOrder) {
+
+	auto rowRemap = std::vector<std::optional<size_t>>(rowOrder.size());
+	for (size_t row = 0; row < rowOrder.size(); ++row) {
+		rowRemap[rowOrder[row]] = row;
+	}
+
+	for (const auto &componentCollection: componentCollections) {
+		componentCollection->reorder(rowOrder);
+	}
+	return rowRemap;
+}
+
+void Archetype::shrinkToFit() {
+
+	for (const auto &componentCollection: componentCollections) {
+		if (componentCollection->getCollectionCapacity() > componentCollection->getCollectionLength()) {
+			componentCollection->shrinkToFit();
+		}
+	}
+}
+
+void Archetype::reserveRows(size_t additionalRowCount) {
+
+	size_t capacity = getRowCount() + additionalRowCount;
+	for (const auto &componentCollection: componentCollections) {
+		componentCollection->reserve(capacity);
+	}
+}
+
+bool Archetype::isRowVacant(size_t row) const {
+	if (componentCollections.empty()) return false;
+	return componentCollections[0]->isVacant(row);
+}
+
+std::vector<std::type_index> Archetype::getComponentTypes() const {
+	auto componentTypes = std::vector<std::type_index>(componentCollections.size(), typeid(void));
+	for (const auto &typeEntry: componentTypeMap) {
+		componentTypes[typeEntry.second] = typeEntry.first;
+	}
+	return componentTypes;
+}
+
+std::optional<ComponentInstanceCollection *> Archetype::getCollection(std::type_index typeId) {
+	if (!componentTypeMap.contains(typeId)) return std::nullopt;
+	return std::make_optional(componentCollections[componentTypeMap[typeId]].get());
+}
+
+size_t Archetype::getMemoryFootprint() const {
+	size_t bytes = 0;
+	for (const auto &componentCollection: componentCollections) {
+		bytes += componentCollection->getMemoryFootprint();
+	}
+	return bytes;
+}
@@ -105,6 +105,13 @@ class Archetype {
 			return std::make_optional<std::unique_ptr<Archetype>>(std::move(instance));
 		}
 
+		/// Create a new archetype from a set of already existing component collections.
+		/// \param collections -> The component type and collection of every component the archetype shall contain.
+		/// All collections must have the same length.
+		/// \return A new instance of an archetype.
+		static std::unique_ptr<Archetype>
+		createFromCollections(std::vector<std::pair<std::type_index, std::unique_ptr<ComponentInstanceCollection>>> collections);
+
 		/// Checks if an archetype is equipped with the requested component.
 		/// \tparam T -> The component to test for.
 		/// \return True if the archetype contains the component T, otherwise returns false.
@@ -172,6 +179,8 @@ class Archetype {
 			if (target_collection.size() <= index) {
 				return std::nullopt;
 			}
+			// The instance is handed out for writing, so the row counts as changed for change tracking.
+			if (target_collection[index]) componentCollection->markChanged(index);
 			return std::make_optional(target_collection.at(index));
 		}
 
@@ -193,6 +202,53 @@ class Archetype {
 		/// \param entityIndex -> The entity index of the old archetype that shall be migrated.
 		std::optional<size_t> migrateEntity(std::unique_ptr<Archetype> &from, const size_t &entityIndex);
 
+		/// Release all component instances of an entity but keep its row as a vacant slot, so the indices of all other
+		/// entities in this archetype stay valid. Vacant rows are reclaimed by compactRows().
+		/// \param entityIndex -> The entity index to vacate.
+		void vacateEntityIndex(size_t entityIndex);
+
+		/// Fetch the amount of rows in this archetype, including vacant rows left behind by migrated entities.
+		size_t getRowCount() const;
+
+		/// Fetch the amount of rows in this archetype that still hold component instances.
+		size_t getEntityCount() const;
+
+		/// Fetch the amount of rows the component collections can hold before they have to reallocate.
+		size_t getRowCapacity() const;
+
+		/// Erase all vacant rows from this archetype.
+		/// \return The new index of every old row. Vacant rows are mapped to std::nullopt.
+		std::vector<std::optional<size_t>> compactRows();
+
+		/// Rearrange the rows of all component collections together, e.g. to sort them by a key.
+		/// \param rowOrder -> The old index of the row that moves to each index. Must be a permutation of all rows.
+		/// \return The new index of every old row.
+		std::vector<std::optional<size_t>> reorderRows(const std::vector<size_t> &rowOrder);
+
+		/// Release the memory of all component collections that exceeds the current row count.
+		void shrinkToFit();
+
+		/// Grow all component collections, so the given amount of rows can be added without reallocating.
+		/// \param additionalRowCount -> The amount of rows to make room for behind the current rows.
+		void reserveRows(size_t additionalRowCount);
+
+		/// Fetch the amount of bytes all component collections of this archetype occupy.
+		size_t getMemoryFootprint() const;
+
+		/// Check if a row has been left behind by a migrated entity.
+		/// \param row -> The row to check.
+		/// \return True if the row does not hold any component instances.
+		bool isRowVacant(size_t row) const;
+
+		/// Collect the types of all components stored in this archetype.
+		/// \return The component types, ordered by the index of their collection.
+		std::vector<std::type_index> getComponentTypes() const;
+
+		/// Get the collection that stores the instances of a component type.
+		/// \param typeId -> The type index of the component.
+		/// \return Pointer to the collection or nullopt if the archetype does not contain the component.
+		std::optional<ComponentInstanceCollection *> getCollection(std::type_index typeId);
+
 	private:
 
 		std::unordered_map<std::type_index, size_t> componentTypeMap;
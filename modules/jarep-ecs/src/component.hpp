@@ -5,10 +5,92 @@
 #ifndef JAREP_COMPONENT_HPP
 #define JAREP_COMPONENT_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
 class Component{
     public:
         Component()= default;
         virtual ~Component() = default;
 };
 
+/// Components are polymorphic and therefore never trivially copyable. A component whose own members are all trivially
+/// copyable can declare `static constexpr bool isPlainData = true;` to allow the ecs to handle these members as raw bytes.
+template<class T>
+concept PlainComponent = std::is_base_of_v<Component, T> && requires { requires T::isPlainData; };
+
+/// Get the byte offset at which the members of a plain component start, right behind the Component base. The offset is
+/// not rounded up to alignof(T): a member with a weaker alignment than an over-aligned one behind it starts directly
+/// behind the base, the padding in front of the over-aligned member is copied along.
+template<PlainComponent T>
+constexpr size_t plainDataOffset() {
+    static_assert(sizeof(T) >= sizeof(Component), "A plain component must contain its Component base.");
+    return sizeof(Component);
+}
+
+/// Get the amount of bytes the members of a plain component occupy.
+template<PlainComponent T>
+constexpr size_t plainDataSize() {
+    return sizeof(T) - plainDataOffset<T>();
+}
+
+/// Copy the members of a plain component into a raw byte buffer.
+/// \param component -> The component to read from.
+/// \param destination -> The buffer to write to. Must hold at least plainDataSize<T>() bytes.
+template<PlainComponent T>
+void readPlainData(const T &component, std::byte *destination) {
+    std::memcpy(destination, reinterpret_cast<const std::byte *>(&component) + plainDataOffset<T>(), plainDataSize<T>());
+}
+
+/// Overwrite the members of a plain component with the content of a raw byte buffer.
+/// \param component -> The component to write to.
+/// \param source -> The buffer to read from. Must hold at least plainDataSize<T>() bytes.
+template<PlainComponent T>
+void writePlainData(T &component, const std::byte *source) {
+    std::memcpy(reinterpret_cast<std::byte *>(&component) + plainDataOffset<T>(), source, plainDataSize<T>());
+}
+
+/// Get the alignment the instances of a component type are allocated with. It is derived from alignof(T), a component
+/// can request a stronger one with `static constexpr size_t alignment = 64;`, e.g. to keep instances that are written by
+/// different threads on separate cache lines.
+template<class T>
+constexpr size_t getComponentAlignment() {
+    if constexpr (requires { { T::alignment } -> std::convertible_to<size_t>; }) {
+        return std::max(alignof(T), static_cast<size_t>(T::alignment));
+    } else {
+        return alignof(T);
+    }
+}
+
+/// Create a component instance aligned to getComponentAlignment<T>(). Instances with an alignment override are padded
+/// to a multiple of their alignment, so no other allocation can share their last cache line.
+/// \param args -> The arguments passed to the constructor of the component.
+template<class T, class... Args>
+std::shared_ptr<T> createComponentInstance(Args &&... args) {
+    constexpr size_t alignment = getComponentAlignment<T>();
+    if constexpr (alignment == alignof(T)) {
+        // The standard allocator already respects the natural alignment, including over-aligned types.
+        return std::make_shared<T>(std::forward<Args>(args)...);
+    } else {
+        constexpr size_t paddedSize = (sizeof(T) + alignment - 1) / alignment * alignment;
+        void *memory = ::operator new(paddedSize, std::align_val_t(alignment));
+        T *instance;
+        try {
+            instance = new(memory) T(std::forward<Args>(args)...);
+        } catch (...) {
+            ::operator delete(memory, std::align_val_t(alignment));
+            throw;
+        }
+        return std::shared_ptr<T>(instance, [](T *component) {
+            component->~T();
+            ::operator delete(static_cast<void *>(component), std::align_val_t(alignment));
+        });
+    }
+}
+
 #endif //JAREP_COMPONENT_HPP
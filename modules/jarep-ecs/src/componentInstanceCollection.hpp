@@ -6,9 +6,14 @@
 #define JAREP_COMPONENTINSTANCECOLLECTION_HPP
 
 #include <vector>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <any>
+#include <algorithm>
+#include "soacolumn.hpp"
+#include "rowbitmask.hpp"
 
 
 /// This pattern is called "Curiously recurring template pattern" (CRTP). It allows the compiler to
@@ -41,12 +46,94 @@ class ComponentInstanceCollection {
         /// \param target -> The target collection to which this element shall migrate.
         virtual void migrate(size_t index, ComponentInstanceCollection &other) = 0;
 
+        /// Migrate a contiguous range of entries from this collection to the end of another collection at once.
+        /// \param firstIndex -> The entity index of the first element that should be migrated.
+        /// \param count -> The amount of elements to migrate.
+        /// \param target -> The target collection to which the elements shall migrate.
+        virtual void migrateRange(size_t firstIndex, size_t count, ComponentInstanceCollection &target) = 0;
+
+        /// Move all entries of another collection to the end of this collection.
+        /// \param other -> The collection to take the entries from. Must store the same component type as this one.
+        virtual void append(ComponentInstanceCollection &other) = 0;
+
+        /// Append copies of a single entry to another collection.
+        /// \param index -> The index of the entry to copy.
+        /// \param count -> The amount of copies to append.
+        /// \param target -> The collection to append the copies to. Must store the same component type as this one.
+        virtual void appendCopies(size_t index, size_t count, ComponentInstanceCollection &target) = 0;
+
+        /// Make another collection an exact copy of this one, including vacant slots and disabled entries. Instances the
+        /// target already holds are overwritten in place, so a target that is copied into repeatedly does not allocate.
+        /// \param target -> The collection to overwrite. Must store the same component type as this one.
+        virtual void copyInto(ComponentInstanceCollection &target) const = 0;
+
         /// Fetch the amount of entries in this collection.
         virtual size_t getCollectionLength() = 0;
 
+        /// Fetch the amount of entries this collection can hold before it has to reallocate.
+        virtual size_t getCollectionCapacity() = 0;
+
+        /// Check if the entry at the given index has been migrated away and only a vacant slot is left behind.
+        /// \param index -> The entity index to check.
+        /// \return True if the slot does not hold a component instance anymore.
+        virtual bool isVacant(size_t index) = 0;
+
+        /// Release the component instance at the given index and leave a vacant slot behind.
+        /// \param index -> The index of the entity to which this item belongs.
+        virtual void vacate(size_t index) = 0;
+
+        /// Erase all vacant slots from this collection. The order of the remaining entries is preserved.
+        virtual void removeVacant() = 0;
+
+        /// Rearrange all entries of this collection.
+        /// \param rowOrder -> The old index of the entry that moves to each index. Must be a permutation of all indices.
+        virtual void reorder(const std::vector<size_t> &rowOrder) = 0;
+
+        /// Release the memory this collection holds beyond its current length.
+        virtual void shrinkToFit() = 0;
+
+        /// Allocate memory for at least the given amount of entries, so adding entries does not reallocate.
+        /// \param capacity -> The amount of entries the collection shall be able to hold.
+        virtual void reserve(size_t capacity) = 0;
+
+        /// Fetch the amount of bytes the collection and the component instances it holds occupy.
+        virtual size_t getMemoryFootprint() = 0;
+
+        /// Enable or disable the entry at the given index without moving it. Disabled entries stay in the collection but
+        /// are skipped by queries.
+        /// \param index -> The entity index of the entry.
+        /// \param enabled -> The new state of the entry.
+        virtual void setEnabled(size_t index, bool enabled) = 0;
+
+        /// Check if the entry at the given index is enabled. Entries are enabled unless they have been disabled.
+        /// \param index -> The entity index of the entry.
+        virtual bool isEnabled(size_t index) = 0;
+
+        /// Get the mask with one set bit per disabled entry.
+        virtual const RowBitmask &getDisabledRows() = 0;
+
+        /// Mark the entry at the given index as changed, e.g. because it has been handed out for writing.
+        /// \param index -> The entity index of the entry.
+        virtual void markChanged(size_t index) = 0;
+
+        /// Get the mask with one set bit per entry that has been added or handed out for writing since the changes have
+        /// been cleared the last time.
+        virtual const RowBitmask &getChangedRows() = 0;
+
+        /// Forget all changes.
+        virtual void clearChangedRows() = 0;
+
+        /// Fetch a version that identifies the current content of this collection. The version changes whenever the
+        /// collection is modified or handed out for writing and is never shared between two collections, so a copy can
+        /// be skipped if the version matches the one the copy has been taken at.
+        virtual uint64_t getContentVersion() = 0;
+
         /// Gets the hash value of this collection instance.
         /// \return The hash valur of this collection.
         virtual size_t getHashValue() = 0;
+
+    protected:
+        static inline std::atomic<uint64_t> nextContentVersion = 1;
 };
 
 template<class T>
@@ -67,6 +154,76 @@ class InstanceCollection : public ComponentInstanceCollection {
             return componentList.size();
         }
 
+        /// Fetch the amount of entries this collection can hold before it has to reallocate.
+        size_t getCollectionCapacity() override {
+            return componentList.capacity();
+        }
+
+        /// Check if the entry at the given index has been migrated away and only a vacant slot is left behind.
+        /// \param index -> The entity index to check.
+        bool isVacant(size_t index) override {
+            return index < componentList.size() && componentList[index] == nullptr;
+        }
+
+        /// Release the component instance at the given index and leave a vacant slot behind.
+        /// \param index -> The index of the entity to which this item belongs.
+        void vacate(size_t index) override {
+            if (index >= componentList.size()) return;
+            isContentChanged = true;
+            componentList[index].reset();
+            disabledRows.set(index, false);
+            changedRows.set(index, false);
+        }
+
+        /// Erase all vacant slots from this collection. The order of the remaining entries is preserved.
+        void removeVacant() override {
+            isContentChanged = true;
+            if (disabledRows.count() > 0 || changedRows.count() > 0) {
+                // The disabled and changed entries move down together with their instances.
+                auto compactedDisabledRows = RowBitmask();
+                auto compactedChangedRows = RowBitmask();
+                size_t newIndex = 0;
+                for (size_t index = 0; index < componentList.size(); ++index) {
+                    if (componentList[index] == nullptr) continue;
+                    compactedDisabledRows.set(newIndex, disabledRows.test(index));
+                    compactedChangedRows.set(newIndex, changedRows.test(index));
+                    newIndex++;
+                }
+                disabledRows = std::move(compactedDisabledRows);
+                changedRows = std::move(compactedChangedRows);
+            }
+            std::erase(componentList, nullptr);
+        }
+
+        /// Rearrange all entries of this collection.
+        /// \param rowOrder -> The old index of the entry that moves to each index. Must be a permutation of all indices.
+        void reorder(const std::vector<size_t> &rowOrder) override {
+            isContentChanged = true;
+            auto reorderedList = std::vector<std::shared_ptr<T>>();
+            auto reorderedDisabledRows = RowBitmask();
+            auto reorderedChangedRows = RowBitmask();
+            reorderedList.reserve(componentList.capacity());
+            for (size_t index = 0; index < rowOrder.size(); ++index) {
+                reorderedList.push_back(std::move(componentList[rowOrder[index]]));
+                if (disabledRows.test(rowOrder[index])) reorderedDisabledRows.set(index, true);
+                if (changedRows.test(rowOrder[index])) reorderedChangedRows.set(index, true);
+            }
+            componentList = std::move(reorderedList);
+            disabledRows = std::move(reorderedDisabledRows);
+            changedRows = std::move(reorderedChangedRows);
+        }
+
+        /// Release the memory this collection holds beyond its current length.
+        void shrinkToFit() override {
+            componentList.shrink_to_fit();
+        }
+
+        /// Allocate memory for at least the given amount of entries, so adding entries does not reallocate.
+        /// \param capacity -> The amount of entries the collection shall be able to hold.
+        void reserve(size_t capacity) override {
+            componentList.reserve(capacity);
+        }
+
         /// Get the instance of this collection immutable.
         const std::any as_any_const() const override {
             return std::any(std::reference_wrapper(componentList));
@@ -74,6 +231,7 @@ class InstanceCollection : public ComponentInstanceCollection {
 
         /// Get the instance of this collection mutable.
         std::any as_any() override {
+            isContentChanged = true;
             return std::any(std::reference_wrapper(componentList));
         }
 
@@ -81,7 +239,10 @@ class InstanceCollection : public ComponentInstanceCollection {
         /// \param index -> The index of the entity to which this item belongs.
         void removeAt(size_t index) override {
             if (index >= componentList.size()) return;
+            isContentChanged = true;
             componentList.erase(componentList.begin() + index);
+            disabledRows.erase(index);
+            changedRows.erase(index);
         }
 
         /// Migrate entries from this collection to another collection.
@@ -89,7 +250,156 @@ class InstanceCollection : public ComponentInstanceCollection {
         /// \param target -> The target collection to which this element shall migrate.
         void migrate(size_t index, ComponentInstanceCollection &target) override {
            std::shared_ptr<T> value = std::move(componentList[index]);
-            static_cast<InstanceCollection<T> &>(target).componentList.push_back(std::move(value));
+            auto &targetCollection = static_cast<InstanceCollection<T> &>(target);
+            isContentChanged = true;
+            targetCollection.isContentChanged = true;
+            targetCollection.componentList.push_back(std::move(value));
+            targetCollection.disabledRows.set(targetCollection.componentList.size() - 1, disabledRows.test(index));
+            targetCollection.changedRows.set(targetCollection.componentList.size() - 1, true);
+            disabledRows.set(index, false);
+            changedRows.set(index, false);
+        }
+
+        /// Migrate a contiguous range of entries from this collection to the end of another collection at once. The
+        /// instances are handed over with a single bulk insert and the range is left vacant.
+        /// \param firstIndex -> The entity index of the first element that should be migrated.
+        /// \param count -> The amount of elements to migrate.
+        /// \param target -> The target collection to which the elements shall migrate.
+        void migrateRange(size_t firstIndex, size_t count, ComponentInstanceCollection &target) override {
+            if (count == 0 || firstIndex + count > componentList.size()) return;
+            auto &targetCollection = static_cast<InstanceCollection<T> &>(target);
+            isContentChanged = true;
+            targetCollection.isContentChanged = true;
+            auto &targetList = targetCollection.componentList;
+            size_t firstTargetIndex = targetList.size();
+            auto first = componentList.begin() + static_cast<std::ptrdiff_t>(firstIndex);
+            targetList.insert(targetList.end(), std::make_move_iterator(first),
+                              std::make_move_iterator(first + static_cast<std::ptrdiff_t>(count)));
+            targetCollection.changedRows.setRange(firstTargetIndex, count);
+            for (size_t offset = 0; offset < count; ++offset) {
+                changedRows.set(firstIndex + offset, false);
+                if (!disabledRows.test(firstIndex + offset)) continue;
+                targetCollection.disabledRows.set(firstTargetIndex + offset, true);
+                disabledRows.set(firstIndex + offset, false);
+            }
+        }
+
+        /// Move all entries of another collection to the end of this collection.
+        /// \param other -> The collection to take the entries from. Must store the same component type as this one.
+        void append(ComponentInstanceCollection &other) override {
+            auto &otherCollection = static_cast<InstanceCollection<T> &>(other);
+            auto &otherList = otherCollection.componentList;
+            isContentChanged = true;
+            otherCollection.isContentChanged = true;
+            disabledRows.insert(otherCollection.disabledRows, componentList.size(), otherList.size());
+            changedRows.setRange(componentList.size(), otherList.size());
+            componentList.insert(componentList.end(), std::make_move_iterator(otherList.begin()),
+                                 std::make_move_iterator(otherList.end()));
+            otherList.clear();
+            otherCollection.disabledRows.clear();
+            otherCollection.changedRows.clear();
+        }
+
+        /// Append copies of a single entry to another collection.
+        /// \param index -> The index of the entry to copy.
+        /// \param count -> The amount of copies to append.
+        /// \param target -> The collection to append the copies to. Must store the same component type as this one.
+        void appendCopies(size_t index, size_t count, ComponentInstanceCollection &target) override {
+            auto &targetCollection = static_cast<InstanceCollection<T> &>(target);
+            auto &targetList = targetCollection.componentList;
+            const T &source = *componentList[index];
+            const bool isSourceDisabled = disabledRows.test(index);
+            targetCollection.isContentChanged = true;
+            targetList.reserve(targetList.size() + count);
+            targetCollection.changedRows.setRange(targetList.size(), count);
+            for (size_t i = 0; i < count; ++i) {
+                targetList.push_back(createComponentInstance<T>(source));
+                if (isSourceDisabled) targetCollection.disabledRows.set(targetList.size() - 1, true);
+            }
+        }
+
+        /// Make another collection an exact copy of this one, including vacant slots and disabled entries. Instances the
+        /// target already holds are overwritten in place, so a target that is copied into repeatedly does not allocate.
+        /// \param target -> The collection to overwrite. Must store the same component type as this one.
+        void copyInto(ComponentInstanceCollection &target) const override {
+            auto &targetCollection = static_cast<InstanceCollection<T> &>(target);
+            auto &targetList = targetCollection.componentList;
+            targetCollection.isContentChanged = true;
+            targetList.resize(componentList.size());
+            for (size_t index = 0; index < componentList.size(); ++index) {
+                const auto &component = componentList[index];
+                auto &targetComponent = targetList[index];
+                if (!component) {
+                    targetComponent.reset();
+                    continue;
+                }
+                if constexpr (std::is_copy_assignable_v<T>) {
+                    if (targetComponent) {
+                        *targetComponent = *component;
+                        continue;
+                    }
+                }
+                targetComponent = createComponentInstance<T>(*component);
+            }
+            targetCollection.disabledRows = disabledRows;
+            // Every entry of the target may have been overwritten.
+            targetCollection.changedRows.clear();
+            targetCollection.changedRows.setRange(0, targetList.size());
+        }
+
+        /// Fetch the amount of bytes the collection and the component instances it holds occupy. The bookkeeping memory of
+        /// the shared pointers is not included.
+        size_t getMemoryFootprint() override {
+            size_t instanceCount = componentList.size() - std::count(componentList.begin(), componentList.end(), nullptr);
+            return componentList.capacity() * sizeof(std::shared_ptr<T>) + instanceCount * sizeof(T);
+        }
+
+        /// Enable or disable the entry at the given index without moving it.
+        /// \param index -> The entity index of the entry.
+        /// \param enabled -> The new state of the entry.
+        void setEnabled(size_t index, bool enabled) override {
+            if (index >= componentList.size()) return;
+            isContentChanged = true;
+            disabledRows.set(index, !enabled);
+        }
+
+        /// Check if the entry at the given index is enabled.
+        /// \param index -> The entity index of the entry.
+        bool isEnabled(size_t index) override {
+            return !disabledRows.test(index);
+        }
+
+        /// Get the mask with one set bit per disabled entry.
+        const RowBitmask &getDisabledRows() override {
+            return disabledRows;
+        }
+
+        /// Mark the entry at the given index as changed.
+        /// \param index -> The entity index of the entry.
+        void markChanged(size_t index) override {
+            if (index >= componentList.size()) return;
+            isContentChanged = true;
+            changedRows.set(index, true);
+        }
+
+        /// Get the mask with one set bit per entry that has been added or handed out for writing.
+        const RowBitmask &getChangedRows() override {
+            return changedRows;
+        }
+
+        /// Forget all changes.
+        void clearChangedRows() override {
+            changedRows.clear();
+        }
+
+        /// Fetch a version that identifies the current content of this collection. A new version is only drawn once the
+        /// content has changed since the last call, so marking rows as changed stays a plain store.
+        uint64_t getContentVersion() override {
+            if (isContentChanged) {
+                contentVersion = nextContentVersion++;
+                isContentChanged = false;
+            }
+            return contentVersion;
         }
 
         /// Gets the hash value of this collection instance.
@@ -99,8 +409,32 @@ class InstanceCollection : public ComponentInstanceCollection {
             return hasher(*this);
         }
 
+        /// Copy the fields of a SoA component into the field arrays of this collection.
+        /// \param skippedRows The rows that read as zero, e.g. the rows disabled in any column of a query.
+        /// \return The field arrays, valid until the collection is modified.
+        typename SoAColumnStorage<T>::type &gatherSoAColumn(const RowBitmask &skippedRows) requires SoAComponent<T> {
+            soaColumn.gather(componentList, skippedRows);
+            return soaColumn;
+        }
+
+        /// Write the field arrays of a SoA component back into the component instances and mark the written rows as
+        /// changed.
+        /// \param skippedRows The rows that are neither written nor marked. Must be the rows skipped by the gather.
+        void scatterSoAColumn(const RowBitmask &skippedRows) requires SoAComponent<T> {
+            soaColumn.scatter(componentList, skippedRows);
+            isContentChanged = true;
+            for (size_t row = 0; row < componentList.size(); ++row) {
+                if (componentList[row] && !skippedRows.test(row)) changedRows.set(row, true);
+            }
+        }
+
     private:
         std::vector<std::shared_ptr<T>> componentList;
+        RowBitmask disabledRows;
+        RowBitmask changedRows;
+        typename SoAColumnStorage<T>::type soaColumn;
+        bool isContentChanged = true;
+        uint64_t contentVersion = 0;
 
 };
 
@@ -16,12 +16,18 @@
 #include "signature.hpp"
 #include "component.hpp"
 #include "archetype.hpp"
+#include "componentregistry.hpp"
 
 class ComponentManager {
 
 	public:
-		ComponentManager() {
-			nextComponentType = 1;
+		/// Create a component manager with its own component registry.
+		ComponentManager() : ComponentManager(std::make_shared<ComponentRegistry>()) {}
+
+		/// Create a component manager whose signature bits are assigned by a registry that may be shared with others.
+		/// \param componentRegistry The registry assigning the signature bits.
+		explicit ComponentManager(std::shared_ptr<ComponentRegistry> componentRegistry) {
+			this->componentRegistry = std::move(componentRegistry);
 			componentBitMap = std::unordered_map<std::type_index, Signature>();
 
 			archetypeSignatureMap = std::unordered_map<Signature, std::unique_ptr<Archetype>>();
@@ -34,14 +40,23 @@ class ComponentManager {
 		/// \tparam T The component type to register. Must be a deriving class of Component
 		template<class T, class = typename std::enable_if<std::is_base_of<Component, T>::value>::type>
 		void registerComponent() {
-			if (nextComponentType >= MAX_COMPONENTS) {
-				return;
-			}
+			registerComponent(typeid(T));
+		}
 
-			if (componentBitMap.contains(std::type_index(typeid(T)))) return;
+		/// Register a component by its type index, e.g. for a type that is only known from another world.
+		/// \param typeIndex The type index of the component. Must be a deriving class of Component.
+		void registerComponent(std::type_index typeIndex) {
+			if (componentBitMap.contains(typeIndex)) return;
+
+			// The bit is assigned by the registry and cached, so signature lookups never take the registry lock.
+			auto signatureResult = componentRegistry->registerComponent(typeIndex);
+			if (!signatureResult.has_value()) return;
+			componentBitMap.insert_or_assign(typeIndex, signatureResult.value());
+		}
 
-			componentBitMap.insert_or_assign(std::type_index(typeid(T)), Signature(nextComponentType));
-			++nextComponentType;
+		/// Get the registry that assigns the signature bits of this manager.
+		std::shared_ptr<ComponentRegistry> getComponentRegistry() const {
+			return componentRegistry;
 		}
 
 		/// Check if a component is already registered.
@@ -93,11 +108,12 @@ class ComponentManager {
 				return std::nullopt;
 			}
 
-			if ((oldSignature & componentBitMap[typeid(T)]) != oldSignature) return std::nullopt;
+			if ((oldSignature & componentBitMap[typeid(T)]).none()) return std::nullopt;
 
 			auto newSignature = oldSignature & ~componentBitMap[typeid(T)];
 			if (newSignature == Signature(0)) {
-				removeEntityComponents(oldSignature, entityIndex);
+				// Vacate the row instead of erasing it, like a migration does, so the indices of the remaining entities stay valid.
+				archetypeSignatureMap[oldSignature]->vacateEntityIndex(entityIndex);
 				return std::make_optional(std::make_pair(newSignature, 0));
 			}
 
@@ -150,6 +166,30 @@ class ComponentManager {
 		}
 
 
+		/// Enable or disable a component of an entity without moving it to another archetype.
+		/// \param signature The signature of the archetype the component is stored in.
+		/// \param entityIndex The index of the entity in the archetype.
+		/// \param componentType The type index of the component.
+		/// \param enabled The new state of the component.
+		/// \return False if the archetype does not contain the component type.
+		bool setComponentEnabled(Signature signature, size_t entityIndex, std::type_index componentType, bool enabled) {
+			auto collection = getCollection(signature, componentType);
+			if (!collection.has_value()) return false;
+			collection.value()->setEnabled(entityIndex, enabled);
+			return true;
+		}
+
+		/// Check if a component of an entity is enabled.
+		/// \param signature The signature of the archetype the component is stored in.
+		/// \param entityIndex The index of the entity in the archetype.
+		/// \param componentType The type index of the component.
+		/// \return The state of the component or nullopt if the archetype does not contain the component type.
+		std::optional<bool> isComponentEnabled(Signature signature, size_t entityIndex, std::type_index componentType) {
+			auto collection = getCollection(signature, componentType);
+			if (!collection.has_value()) return std::nullopt;
+			return std::make_optional(collection.value()->isEnabled(entityIndex));
+		}
+
 		/// Collect all components of the requested types and return them with their respected signature and entity index for identification.
 		/// \tparam T The requested component type
 		/// \return Collection of all components of this type, alongside the signature of the archetype they are stored in and the entity index.
@@ -177,6 +217,67 @@ class ComponentManager {
 			archetypeSignatureMap[signature]->removeComponentsAtEntityIndex(entityIndex);
 		}
 
+		/// Release the components of an entity and leave its row vacant, so no other row of the archetype moves. The row
+		/// is erased by the next compaction of the archetype.
+		/// \param signature The signature, this entity refers to.
+		/// \param entityIndex The index of the entity at which the components are stored in the archetype.
+		void vacateEntityComponents(Signature signature, size_t entityIndex) {
+			if (!archetypeSignatureMap.contains(signature)) return;
+			archetypeSignatureMap[signature]->vacateEntityIndex(entityIndex);
+		}
+
+
+		/// Collect the signatures of all archetypes currently stored.
+		/// \return The signatures of all archetypes, including the empty root archetype.
+		std::vector<Signature> getArchetypeSignatures() const {
+			auto signatures = std::vector<Signature>();
+			signatures.reserve(archetypeSignatureMap.size());
+			for (const auto &signatureArchetype: archetypeSignatureMap) {
+				signatures.push_back(signatureArchetype.first);
+			}
+			return signatures;
+		}
+
+		/// Erase the vacant rows of an archetype and release the memory its component collections hold beyond their length.
+		/// \param signature The signature of the archetype to compact.
+		/// \return The new index of every old row or nullopt if the archetype does not exist.
+		std::optional<std::vector<std::optional<size_t>>> compactArchetype(Signature signature) {
+			if (!archetypeSignatureMap.contains(signature)) return std::nullopt;
+
+			auto &archetype = archetypeSignatureMap[signature];
+			auto rowRemap = archetype->compactRows();
+			archetype->shrinkToFit();
+			return std::make_optional(rowRemap);
+		}
+
+		/// Get an archetype by its signature.
+		/// \param signature The signature of the requested archetype.
+		/// \return Pointer to the archetype or nullopt if no archetype with this signature exists.
+		std::optional<Archetype *> getArchetype(Signature signature) {
+			if (!archetypeSignatureMap.contains(signature)) return std::nullopt;
+			return std::make_optional(archetypeSignatureMap[signature].get());
+		}
+
+		/// Store a new archetype. An existing archetype with the same signature is not replaced.
+		/// \param signature The signature of the archetype, composed of the signatures of all its component types.
+		/// \param archetype The archetype to store.
+		/// \return True if the archetype has been stored.
+		bool insertArchetype(Signature signature, std::unique_ptr<Archetype> archetype) {
+			if (archetypeSignatureMap.contains(signature)) return false;
+			archetypeSignatureMap.insert_or_assign(signature, std::move(archetype));
+			return true;
+		}
+
+		/// Destroy an archetype if it does not contain any rows anymore. The root archetype is never destroyed.
+		/// \param signature The signature of the archetype to destroy.
+		/// \return True if the archetype has been destroyed.
+		bool removeArchetypeIfEmpty(Signature signature) {
+			if (signature == Signature(0) || !archetypeSignatureMap.contains(signature)) return false;
+			if (archetypeSignatureMap[signature]->getRowCount() > 0) return false;
+
+			archetypeSignatureMap.erase(signature);
+			return true;
+		}
 
 		std::optional<Signature> getCombinedSignatureOfTypes(std::vector<std::type_index> typeIndices) {
 			Signature resultSignature;
@@ -195,8 +296,13 @@ class ComponentManager {
 	private:
 		std::unordered_map<Signature, std::unique_ptr<Archetype>> archetypeSignatureMap;
 
+		std::shared_ptr<ComponentRegistry> componentRegistry;
 		std::unordered_map<std::type_index, Signature> componentBitMap;
-		std::size_t nextComponentType;
+
+		std::optional<ComponentInstanceCollection *> getCollection(Signature signature, std::type_index componentType) {
+			if (!archetypeSignatureMap.contains(signature)) return std::nullopt;
+			return archetypeSignatureMap.at(signature)->getCollection(componentType);
+		}
 
 		std::optional<Signature> getSignatureOfType(std::type_index typeIndex) {
 			if (componentBitMap.contains(typeIndex)) {
@@ -216,8 +322,12 @@ class GetComponentsFunc {
 	public:
 		explicit GetComponentsFunc(std::shared_ptr<ComponentManager> cm) : componentManager(std::move(cm)) {}
 
+		/// Get a component for a system. Disabled components are treated as if the entity did not have them.
 		template<typename T>
 		std::optional<std::shared_ptr<T>> operator()(Signature signature, size_t entityIndex) const {
+			if (componentManager->isComponentEnabled(signature, entityIndex, typeid(T)) == std::make_optional(false)) {
+				return std::nullopt;
+			}
 			return componentManager->getComponent<T>(signature, entityIndex, typeid(T));
 		}
 };
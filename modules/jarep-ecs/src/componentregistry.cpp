@@ -0,0 +1,31 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#include "componentregistry.hpp"
+
+ComponentRegistry::ComponentRegistry() {
+	nextComponentType = 1;
+}
+
+std::optional<Signature> ComponentRegistry::registerComponent(std::type_index typeIndex) {
+	std::lock_guard<std::mutex> lock(registryMutex);
+	if (componentBitMap.contains(typeIndex)) return std::make_optional(componentBitMap.at(typeIndex));
+	if (nextComponentType >= MAX_COMPONENTS) return std::nullopt;
+
+	Signature componentSignature = Signature(1) << (nextComponentType - 1);
+	componentBitMap.insert_or_assign(typeIndex, componentSignature);
+	++nextComponentType;
+	return std::make_optional(componentSignature);
+}
+
+std::optional<Signature> ComponentRegistry::getSignature(std::type_index typeIndex) const {
+	std::lock_guard<std::mutex> lock(registryMutex);
+	if (!componentBitMap.contains(typeIndex)) return std::nullopt;
+	return std::make_optional(componentBitMap.at(typeIndex));
+}
+
+size_t ComponentRegistry::getComponentCount() const {
+	std::lock_guard<std::mutex> lock(registryMutex);
+	return componentBitMap.size();
+}
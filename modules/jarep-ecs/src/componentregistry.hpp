@@ -0,0 +1,42 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_COMPONENTREGISTRY_HPP
+#define JAREP_COMPONENTREGISTRY_HPP
+
+#include <mutex>
+#include <optional>
+#include <typeindex>
+#include <unordered_map>
+#include "signature.hpp"
+
+/// Assigns the signature bit of every component type. Worlds that share a registry use the same bits, so a signature
+/// means the same set of component types in all of them. All functions are thread safe.
+class ComponentRegistry {
+
+	public:
+		ComponentRegistry();
+
+		~ComponentRegistry() = default;
+
+		/// Assign a signature bit to a component type. Registering a type twice returns the bit of the first registration.
+		/// \param typeIndex The component type to register.
+		/// \return The signature bit of the type or nullopt if all bits are in use.
+		std::optional<Signature> registerComponent(std::type_index typeIndex);
+
+		/// Get the signature bit of a component type.
+		/// \param typeIndex The component type.
+		/// \return The signature bit of the type or nullopt if the type is not registered.
+		std::optional<Signature> getSignature(std::type_index typeIndex) const;
+
+		/// Fetch the amount of registered component types.
+		size_t getComponentCount() const;
+
+	private:
+		std::unordered_map<std::type_index, Signature> componentBitMap;
+		std::size_t nextComponentType;
+		mutable std::mutex registryMutex;
+};
+
+#endif //JAREP_COMPONENTREGISTRY_HPP
@@ -0,0 +1,283 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_DYNAMICBUFFER_HPP
+#define JAREP_DYNAMICBUFFER_HPP
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <initializer_list>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+#include "component.hpp"
+
+/// Recycles the heap blocks of dynamic buffers that have outgrown their inline capacity. Blocks are grouped into power of
+/// two size classes, so a block released by one buffer can be reused by any other buffer of the same element type.
+template<class T>
+class DynamicBufferPool {
+
+	public:
+		/// Take a block for the given amount of elements from the pool or allocate a new one.
+		/// \param capacity The amount of elements. Must be a power of two.
+		/// \return Uninitialized memory for capacity elements.
+		static T *allocate(size_t capacity) {
+			auto &pool = getPool();
+			{
+				std::lock_guard<std::mutex> lock(pool.mutex);
+				auto &freeBlocks = pool.freeBlocks[getSizeClass(capacity)];
+				if (!freeBlocks.empty()) {
+					void *block = freeBlocks.back();
+					freeBlocks.pop_back();
+					return static_cast<T *>(block);
+				}
+			}
+			return static_cast<T *>(::operator new(capacity * sizeof(T), std::align_val_t(alignof(T))));
+		}
+
+		/// Return a block to the pool. The elements in it must have been destroyed.
+		/// \param block The block to return.
+		/// \param capacity The amount of elements the block has been allocated for.
+		static void deallocate(T *block, size_t capacity) {
+			auto &pool = getPool();
+			std::lock_guard<std::mutex> lock(pool.mutex);
+			pool.freeBlocks[getSizeClass(capacity)].push_back(block);
+		}
+
+		/// Fetch the amount of blocks that wait for being reused.
+		static size_t getPooledBlockCount() {
+			auto &pool = getPool();
+			std::lock_guard<std::mutex> lock(pool.mutex);
+			size_t blockCount = 0;
+			for (const auto &freeBlocks: pool.freeBlocks) {
+				blockCount += freeBlocks.size();
+			}
+			return blockCount;
+		}
+
+		/// Free all blocks that wait for being reused.
+		static void releasePooledBlocks() {
+			auto &pool = getPool();
+			std::lock_guard<std::mutex> lock(pool.mutex);
+			pool.releaseAll();
+		}
+
+	private:
+		struct Pool {
+			std::mutex mutex;
+			std::array<std::vector<void *>, 64> freeBlocks;
+
+			~Pool() { releaseAll(); }
+
+			void releaseAll() {
+				for (auto &blocks: freeBlocks) {
+					for (void *block: blocks) {
+						::operator delete(block, std::align_val_t(alignof(T)));
+					}
+					blocks.clear();
+				}
+			}
+		};
+
+		static Pool &getPool() {
+			static Pool pool;
+			return pool;
+		}
+
+		static size_t getSizeClass(size_t capacity) {
+			return std::bit_width(capacity) - 1;
+		}
+};
+
+/// Component holding a variable amount of elements, e.g. inventory slots or path waypoints. Up to InlineCapacity elements
+/// are stored inside the component itself, so they share the allocation of the component instance and are read without
+/// following another pointer. Larger buffers spill into a block of the DynamicBufferPool of their element type.
+/// Components can either use a buffer directly or derive from it, e.g. `class Waypoints : public DynamicBuffer<Vec3, 8> {};`
+/// \tparam T The element type.
+/// \tparam InlineCapacity The amount of elements stored without a heap block.
+template<class T, size_t InlineCapacity>
+class DynamicBuffer : public Component {
+	static_assert(InlineCapacity > 0, "A dynamic buffer needs an inline capacity of at least one element");
+
+	public:
+		typedef T value_type;
+		typedef T *iterator;
+		typedef const T *const_iterator;
+
+		static constexpr size_t inlineCapacity = InlineCapacity;
+
+		DynamicBuffer() = default;
+
+		DynamicBuffer(std::initializer_list<T> values) {
+			reserve(values.size());
+			for (const auto &value: values) {
+				new(getElements() + elementCount) T(value);
+				elementCount++;
+			}
+		}
+
+		DynamicBuffer(const DynamicBuffer &other) : Component(other) {
+			reserve(other.elementCount);
+			for (const auto &value: other) {
+				new(getElements() + elementCount) T(value);
+				elementCount++;
+			}
+		}
+
+		DynamicBuffer(DynamicBuffer &&other) noexcept : Component(std::move(other)) {
+			takeElements(other);
+		}
+
+		DynamicBuffer &operator=(const DynamicBuffer &other) {
+			if (this == &other) return *this;
+			clear();
+			reserve(other.elementCount);
+			for (const auto &value: other) {
+				new(getElements() + elementCount) T(value);
+				elementCount++;
+			}
+			return *this;
+		}
+
+		DynamicBuffer &operator=(DynamicBuffer &&other) noexcept {
+			if (this == &other) return *this;
+			clear();
+			releaseHeapBlock();
+			takeElements(other);
+			return *this;
+		}
+
+		~DynamicBuffer() override {
+			clear();
+			releaseHeapBlock();
+		}
+
+		/// Append an element constructed from the given arguments.
+		/// \return The new element.
+		template<class... Args>
+		T &emplace_back(Args &&... args) {
+			if (elementCount == capacity()) {
+				// The new element is constructed before the old ones are moved, as the arguments may refer to them.
+				size_t newCapacity = std::bit_ceil(elementCount * 2);
+				T *newElements = DynamicBufferPool<T>::allocate(newCapacity);
+				try {
+					new(newElements + elementCount) T(std::forward<Args>(args)...);
+				} catch (...) {
+					DynamicBufferPool<T>::deallocate(newElements, newCapacity);
+					throw;
+				}
+				moveElementsTo(newElements, newCapacity);
+			} else {
+				new(getElements() + elementCount) T(std::forward<Args>(args)...);
+			}
+			elementCount++;
+			return getElements()[elementCount - 1];
+		}
+
+		void push_back(const T &value) { emplace_back(value); }
+
+		void push_back(T &&value) { emplace_back(std::move(value)); }
+
+		/// Remove the last element.
+		void pop_back() {
+			if (elementCount == 0) return;
+			elementCount--;
+			getElements()[elementCount].~T();
+		}
+
+		/// Remove all elements. A heap block is kept for reuse by this buffer.
+		void clear() {
+			T *elements = getElements();
+			for (size_t index = 0; index < elementCount; ++index) {
+				elements[index].~T();
+			}
+			elementCount = 0;
+		}
+
+		/// Make room for at least the given amount of elements.
+		/// \param newCapacity The amount of elements the buffer shall be able to hold without growing.
+		void reserve(size_t newCapacity) {
+			if (newCapacity <= capacity()) return;
+			size_t blockCapacity = std::bit_ceil(newCapacity);
+			moveElementsTo(DynamicBufferPool<T>::allocate(blockCapacity), blockCapacity);
+		}
+
+		T &operator[](size_t index) { return getElements()[index]; }
+
+		const T &operator[](size_t index) const { return getElements()[index]; }
+
+		T *data() { return getElements(); }
+
+		const T *data() const { return getElements(); }
+
+		iterator begin() { return getElements(); }
+
+		iterator end() { return getElements() + elementCount; }
+
+		const_iterator begin() const { return getElements(); }
+
+		const_iterator end() const { return getElements() + elementCount; }
+
+		[[nodiscard]] size_t size() const { return elementCount; }
+
+		[[nodiscard]] bool empty() const { return elementCount == 0; }
+
+		/// Fetch the amount of elements the buffer can hold before it has to grow.
+		[[nodiscard]] size_t capacity() const { return heapElements ? heapCapacity : InlineCapacity; }
+
+		/// Check if the elements are stored inside the component instead of a heap block.
+		[[nodiscard]] bool isInline() const { return heapElements == nullptr; }
+
+	private:
+		alignas(T) std::byte inlineStorage[sizeof(T) * InlineCapacity];
+		T *heapElements = nullptr;
+		size_t heapCapacity = 0;
+		size_t elementCount = 0;
+
+		T *getElements() {
+			return heapElements ? heapElements : std::launder(reinterpret_cast<T *>(inlineStorage));
+		}
+
+		const T *getElements() const {
+			return heapElements ? heapElements : std::launder(reinterpret_cast<const T *>(inlineStorage));
+		}
+
+		/// Move the elements into a new heap block and release the previous one.
+		void moveElementsTo(T *newElements, size_t newCapacity) {
+			T *elements = getElements();
+			for (size_t index = 0; index < elementCount; ++index) {
+				new(newElements + index) T(std::move(elements[index]));
+				elements[index].~T();
+			}
+			releaseHeapBlock();
+			heapElements = newElements;
+			heapCapacity = newCapacity;
+		}
+
+		void releaseHeapBlock() {
+			if (!heapElements) return;
+			DynamicBufferPool<T>::deallocate(heapElements, heapCapacity);
+			heapElements = nullptr;
+			heapCapacity = 0;
+		}
+
+		/// Take over the elements of another buffer. Heap blocks are handed over, inline elements are moved one by one.
+		void takeElements(DynamicBuffer &other) {
+			if (other.heapElements) {
+				heapElements = std::exchange(other.heapElements, nullptr);
+				heapCapacity = std::exchange(other.heapCapacity, 0);
+				elementCount = std::exchange(other.elementCount, 0);
+				return;
+			}
+			for (auto &value: other) {
+				new(getElements() + elementCount) T(std::move(value));
+				elementCount++;
+			}
+			other.clear();
+		}
+};
+
+#endif //JAREP_DYNAMICBUFFER_HPP
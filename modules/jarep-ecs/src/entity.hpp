@@ -7,4 +7,7 @@
 #include <cstddef>
 
 typedef size_t Entity;
+
+/// Handle of an entity template created by the world.
+typedef size_t Prefab;
 #endif //JAREP_ENTITY_HPP
@@ -4,8 +4,67 @@
 
 #include "entitymanager.hpp"
 
-EntityManager::EntityManager() {
+static std::atomic<uint64_t> nextEntityManagerId = THREAD_LOOKUP_CACHE_EMPTY_ID + 1;
+static std::atomic<uint64_t> nextStructureVersion = 1;
+
+EntityDeadFlags::EntityDeadFlags() : chunks(std::make_unique<std::atomic<std::atomic<uint64_t> *>[]>(CHUNK_COUNT)) {
+	for (size_t chunkIndex = 0; chunkIndex < CHUNK_COUNT; ++chunkIndex) {
+		chunks[chunkIndex].store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+EntityDeadFlags::~EntityDeadFlags() {
+	for (size_t chunkIndex = 0; chunkIndex < CHUNK_COUNT; ++chunkIndex) {
+		delete[] chunks[chunkIndex].load(std::memory_order_relaxed);
+	}
+}
+
+bool EntityDeadFlags::isDead(Entity entity) const {
+	const auto *chunk = chunks[entity >> CHUNK_BITS].load(std::memory_order_acquire);
+	if (chunk == nullptr) return false;
+
+	size_t bitIndex = entity & ((size_t(1) << CHUNK_BITS) - 1);
+	uint64_t word = chunk[bitIndex / 64].load(std::memory_order_acquire);
+	return (word >> (bitIndex % 64)) & 1;
+}
+
+bool EntityDeadFlags::set(Entity entity, bool dead) {
+	auto &chunkSlot = chunks[entity >> CHUNK_BITS];
+	auto *chunk = chunkSlot.load(std::memory_order_acquire);
+	if (chunk == nullptr) {
+		// Indices of a missing chunk are alive already.
+		if (!dead) return false;
+
+		// Chunks are allocated once and never move, another thread may have installed one meanwhile.
+		auto *newChunk = new std::atomic<uint64_t>[WORDS_PER_CHUNK]();
+		if (chunkSlot.compare_exchange_strong(chunk, newChunk, std::memory_order_acq_rel)) {
+			chunk = newChunk;
+		} else {
+			delete[] newChunk;
+		}
+	}
+
+	size_t bitIndex = entity & ((size_t(1) << CHUNK_BITS) - 1);
+	uint64_t bit = uint64_t(1) << (bitIndex % 64);
+	uint64_t oldWord = dead ? chunk[bitIndex / 64].fetch_or(bit, std::memory_order_acq_rel)
+	                        : chunk[bitIndex / 64].fetch_and(~bit, std::memory_order_acq_rel);
+	return ((oldWord & bit) != 0) != dead;
+}
+
+void EntityDeadFlags::clear() {
+	for (size_t chunkIndex = 0; chunkIndex < CHUNK_COUNT; ++chunkIndex) {
+		auto *chunk = chunks[chunkIndex].load(std::memory_order_relaxed);
+		if (chunk == nullptr) continue;
+		for (size_t wordIndex = 0; wordIndex < WORDS_PER_CHUNK; ++wordIndex) {
+			chunk[wordIndex].store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+EntityManager::EntityManager() : managerId(nextEntityManagerId++) {
+	structureVersion = nextStructureVersion++;
 	nextId = 0;
+	deadEntityCount = 0;
 	deadEntities = std::queue<Entity>();
 	entitySignatureMap.clear();
 
@@ -20,20 +79,95 @@ EntityManager::~EntityManager() {
 
 std::optional<Entity> EntityManager::createEntity() {
 
-	Entity newEntity;
-	if (!deadEntities.empty()) {
-		newEntity = deadEntities.front();
-		deadEntities.pop();
-	} else {
-		newEntity = nextId;
-		if (nextId == std::numeric_limits<unsigned int>::max()) {
+	{
+		std::lock_guard<std::mutex> lock(deadEntitiesMutex);
+		if (!deadEntities.empty()) {
+			Entity newEntity = deadEntities.front();
+			deadEntities.pop();
+			if (deadFlags.set(newEntity, false)) deadEntityCount--;
+			return std::make_optional(newEntity);
+		}
+	}
+
+	return claimNewEntity();
+}
+
+void EntityManager::reserve(size_t additionalEntityCount) {
+	size_t entityCount = entitySignatureMap.size() + additionalEntityCount;
+	entitySignatureMap.reserve(entityCount);
+	entityArchetypeIndexMap.reserve(entityCount);
+}
+
+std::optional<Entity> EntityManager::claimNewEntity() {
+	size_t newEntity = nextId.load();
+	do {
+		if (newEntity == std::numeric_limits<unsigned int>::max()) {
 			printf("Exceeded the maximum entities!");
 			return std::nullopt;
 		}
-		nextId += 1;
+	} while (!nextId.compare_exchange_weak(newEntity, newEntity + 1));
+
+	return std::make_optional(Entity(newEntity));
+}
+
+std::optional<Entity> EntityManager::reserveEntity() {
+	auto &threadCache = getThreadCache();
+
+	// Refill the free list of this thread with a whole batch, so the lock is only taken once per batch.
+	if (threadCache.freeEntities.empty()) {
+		std::lock_guard<std::mutex> lock(deadEntitiesMutex);
+		while (!deadEntities.empty() && threadCache.freeEntities.size() < ENTITY_RESERVATION_BATCH_SIZE) {
+			threadCache.freeEntities.push_back(deadEntities.front());
+			deadEntities.pop();
+		}
+	}
+
+	std::optional<Entity> reservedEntity;
+	if (!threadCache.freeEntities.empty()) {
+		reservedEntity = threadCache.freeEntities.back();
+		threadCache.freeEntities.pop_back();
+		// The index stays dead while it waits in the free list and comes alive the moment it is handed out.
+		if (deadFlags.set(reservedEntity.value(), false)) deadEntityCount--;
+	} else {
+		reservedEntity = claimNewEntity();
+		if (!reservedEntity.has_value()) return std::nullopt;
+	}
+
+	threadCache.reservedEntities.push_back(reservedEntity.value());
+	return reservedEntity;
+}
+
+std::vector<Entity> EntityManager::collectReservedEntities() {
+	auto reservedEntities = std::vector<Entity>();
+
+	std::lock_guard<std::mutex> lock(deadEntitiesMutex);
+	for (const auto &threadCache: threadCaches) {
+		reservedEntities.insert(reservedEntities.end(), threadCache->reservedEntities.begin(),
+		                        threadCache->reservedEntities.end());
+		threadCache->reservedEntities.clear();
+
+		for (const Entity freeEntity: threadCache->freeEntities) {
+			deadEntities.push(freeEntity);
+		}
+		threadCache->freeEntities.clear();
 	}
+	return reservedEntities;
+}
 
-	return std::make_optional(newEntity);
+EntityManager::ThreadEntityCache &EntityManager::getThreadCache() {
+	// Every thread remembers its cache in the entity managers it has used last. Manager ids are never reused, so entries
+	// of destroyed managers are never looked up again, and the cache holds a fixed amount of them.
+	thread_local ThreadLookupCache<ThreadEntityCache> cachedThreadCaches;
+	if (auto cachedThreadCache = cachedThreadCaches.find(managerId)) return *cachedThreadCache;
+
+	std::lock_guard<std::mutex> lock(deadEntitiesMutex);
+	auto &threadCache = threadCacheMap[std::this_thread::get_id()];
+	if (!threadCache) {
+		threadCaches.push_back(std::make_unique<ThreadEntityCache>());
+		threadCache = threadCaches.back().get();
+	}
+	cachedThreadCaches.insert(managerId, threadCache);
+	return *threadCache;
 }
 
 void EntityManager::removeEntity(Entity entity) {
@@ -45,9 +179,15 @@ void EntityManager::removeEntity(Entity entity) {
 	size_t removedEntityIndex= entityArchetypeIndexMap[entity];
 
 	// Remove the entity from all lists and mark the entity as dead. Now the entity does not exist anymore.
-	deadEntities.push(entity);
+	if (deadFlags.set(entity, true)) deadEntityCount++;
+	entityGenerationMap[entity]++;
+	{
+		std::lock_guard<std::mutex> lock(deadEntitiesMutex);
+		deadEntities.push(entity);
+	}
 	entitySignatureMap.erase(entity);
 	entityArchetypeIndexMap.erase(entity);
+	structureVersion = nextStructureVersion++;
 
 	// Collect all entities that are also assigned to this signature and therefore the same archetype.
 	auto entitiesWithSameSignature = getAllEntitiesOfSignature(entitySignature);
@@ -61,23 +201,82 @@ void EntityManager::removeEntity(Entity entity) {
 	}
 }
 
+void EntityManager::releaseEntity(Entity entity) {
+
+	if (!isAlive(entity)) return;
+
+	if (deadFlags.set(entity, true)) deadEntityCount++;
+	entityGenerationMap[entity]++;
+	{
+		std::lock_guard<std::mutex> lock(deadEntitiesMutex);
+		deadEntities.push(entity);
+	}
+	entitySignatureMap.erase(entity);
+	entityArchetypeIndexMap.erase(entity);
+	structureVersion = nextStructureVersion++;
+}
+
+void EntityManager::captureState(EntityManagerState &state) const {
+	state.nextId = nextId.load();
+	{
+		std::lock_guard<std::mutex> lock(deadEntitiesMutex);
+		state.deadEntities = deadEntities;
+	}
+
+	// The tables are only copied if they have changed since they have been captured into this state.
+	if (state.structureVersion == structureVersion) return;
+	state.entitySignatureMap = entitySignatureMap;
+	state.entityArchetypeIndexMap = entityArchetypeIndexMap;
+	state.structureVersion = structureVersion;
+}
+
+void EntityManager::restoreState(const EntityManagerState &state) {
+	nextId = state.nextId;
+	{
+		std::lock_guard<std::mutex> lock(deadEntitiesMutex);
+		deadEntities = state.deadEntities;
+		for (const auto &threadCache: threadCaches) {
+			threadCache->freeEntities.clear();
+			threadCache->reservedEntities.clear();
+		}
+
+		deadFlags.clear();
+		auto restoredDeadEntities = state.deadEntities;
+		while (!restoredDeadEntities.empty()) {
+			deadFlags.set(restoredDeadEntities.front(), true);
+			restoredDeadEntities.pop();
+		}
+		deadEntityCount = state.deadEntities.size();
+	}
+	if (state.structureVersion == structureVersion) return;
+	entitySignatureMap = state.entitySignatureMap;
+	entityArchetypeIndexMap = state.entityArchetypeIndexMap;
+	structureVersion = state.structureVersion;
+}
+
 bool EntityManager::isAlive(Entity entity) const{
 	if (entity >= nextId) {
 		throw std::runtime_error("Requesting alive status for uninitialized entities is forbidden!");
 	}
 
-	auto deadEntitiesCopy = deadEntities;
-	for (int i = 0; i < deadEntities.size(); ++i) {
-		if(deadEntitiesCopy.front() == entity)
-			return false;
-		deadEntitiesCopy.pop();
-	}
-	return true;
+	return !deadFlags.isDead(entity);
+}
+
+size_t EntityManager::getDeadEntityCount() const {
+	return deadEntityCount.load();
+}
+
+size_t EntityManager::getCreatableEntityCount() const {
+	const size_t maxEntityCount = std::numeric_limits<unsigned int>::max();
+	size_t newEntityCount = maxEntityCount - std::min(nextId.load(), maxEntityCount);
+	std::lock_guard<std::mutex> lock(deadEntitiesMutex);
+	return deadEntities.size() + newEntityCount;
 }
 
 void EntityManager::assignNewSignature(const Entity entity, const Signature signature, const size_t archetypeIndex) {
 	entitySignatureMap[entity] = signature;
 	entityArchetypeIndexMap[entity] = archetypeIndex;
+	structureVersion = nextStructureVersion++;
 }
 
 std::optional<Signature> EntityManager::getSignature(const Entity entity) const {
@@ -99,4 +298,30 @@ std::vector<Entity> EntityManager::getAllEntitiesOfSignature(Signature signature
 			entitiesWithSignature.push_back(entitySignaturePair.first);
 	}
 	return entitiesWithSignature;
-}
\ No newline at end of file
+}
+
+std::unordered_map<Signature, std::vector<Entity>> EntityManager::getRowEntities() const {
+	auto rowEntities = std::unordered_map<Signature, std::vector<Entity>>();
+	for (const auto &[entity, signature]: entitySignatureMap) {
+		if (signature == Signature(0)) continue;
+		size_t archetypeIndex = entityArchetypeIndexMap.at(entity);
+		auto &entities = rowEntities[signature];
+		if (entities.size() <= archetypeIndex) entities.resize(archetypeIndex + 1);
+		entities[archetypeIndex] = entity;
+	}
+	return rowEntities;
+}
+
+std::vector<Entity> EntityManager::remapArchetypeIndices(Signature signature, const std::vector<std::optional<size_t>> &rowRemap) {
+	auto remappedEntities = std::vector<Entity>();
+	for (const Entity entity: getAllEntitiesOfSignature(signature)) {
+		size_t oldIndex = entityArchetypeIndexMap[entity];
+		if (oldIndex >= rowRemap.size() || !rowRemap[oldIndex].has_value()) continue;
+		if (rowRemap[oldIndex].value() == oldIndex) continue;
+
+		entityArchetypeIndexMap[entity] = rowRemap[oldIndex].value();
+		remappedEntities.push_back(entity);
+	}
+	if (!remappedEntities.empty()) structureVersion = nextStructureVersion++;
+	return remappedEntities;
+}
@@ -5,14 +5,66 @@
 #ifndef JAREP_ENTITYMANAGER_HPP
 #define JAREP_ENTITYMANAGER_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <queue>
 #include <limits>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include <optional>
 #include "signature.hpp"
 #include "entity.hpp"
+#include "threadlookupcache.hpp"
+
+/// The amount of recycled entities a thread moves from the shared dead entity list into its own free list at once.
+const size_t ENTITY_RESERVATION_BATCH_SIZE = 64;
+
+/// The bookkeeping of an entity manager, captured to restore the manager later.
+struct EntityManagerState {
+	/// The version of the signature and archetype index tables when they have been captured.
+	uint64_t structureVersion = 0;
+	size_t nextId = 0;
+	std::queue<Entity> deadEntities;
+	std::unordered_map<Entity, Signature> entitySignatureMap;
+	std::unordered_map<Entity, size_t> entityArchetypeIndexMap;
+};
+
+/// One dead flag per entity index. The flags are packed into chunks that never move once they have been allocated, so a
+/// thread can flip the flag of an index it takes from its free list while other threads check flags without a lock.
+class EntityDeadFlags {
+
+	public:
+		EntityDeadFlags();
+
+		~EntityDeadFlags();
+
+		EntityDeadFlags(const EntityDeadFlags &) = delete;
+
+		EntityDeadFlags &operator=(const EntityDeadFlags &) = delete;
+
+		/// Check if an entity index is dead. Indices that have never been marked are alive.
+		[[nodiscard]] bool isDead(Entity entity) const;
+
+		/// Mark an entity index as dead or alive.
+		/// \return True if the flag has changed.
+		bool set(Entity entity, bool dead);
+
+		/// Mark all entity indices as alive. Must not run while other threads access the flags.
+		void clear();
+
+	private:
+		static constexpr size_t CHUNK_BITS = 20;
+		static constexpr size_t WORDS_PER_CHUNK = (size_t(1) << CHUNK_BITS) / 64;
+		/// Enough chunks for every index below the maximum amount of entities.
+		static constexpr size_t CHUNK_COUNT = (size_t(std::numeric_limits<unsigned int>::max()) >> CHUNK_BITS) + 1;
+
+		std::unique_ptr<std::atomic<std::atomic<uint64_t> *>[]> chunks;
+};
 
 class EntityManager {
 
@@ -25,10 +77,30 @@ class EntityManager {
 		/// \return A new entity index if the creation was successful. Nullopt otherwise.
 		std::optional<Entity> createEntity();
 
+		/// Reserve an entity index from any thread. Recycled indices are taken from a free list of the calling thread,
+		/// which is refilled from the dead entities in batches, new indices are claimed with an atomic counter. The
+		/// entity has no signature until the reservations are collected at the next sync point.
+		/// \return The reserved entity index or nullopt if the maximum amount of entities has been reached.
+		std::optional<Entity> reserveEntity();
+
+		/// Collect the entities reserved by all threads since the last call and return the unused recycled indices of
+		/// the thread free lists to the shared dead entity list. Must not run concurrently with reserveEntity.
+		/// \return The reserved entities, which still need a signature to be assigned.
+		std::vector<Entity> collectReservedEntities();
+
+		/// Grow the signature and archetype index tables, so the given amount of entities can be added without rehashing.
+		/// \param additionalEntityCount The amount of entities to make room for besides the living ones.
+		void reserve(size_t additionalEntityCount);
+
 		/// Remove an entity
 		/// \param entity The entity to remove.
 		void removeEntity(Entity entity);
 
+		/// Remove an entity whose archetype row has been left vacant instead of being erased. The archetype indices of
+		/// all other entities stay unchanged.
+		/// \param entity The entity to remove.
+		void releaseEntity(Entity entity);
+
 		/// Check if an entity is still alive.
 		/// \param entity The entity to check
 		/// \return True if the entity is alive, false otherwise.
@@ -44,6 +116,53 @@ class EntityManager {
 
 		std::optional<size_t> getArchetypeIndex(Entity entity) const;
 
+		/// Move the archetype indices of all entities of a signature to the new rows of their compacted archetype.
+		/// \param signature The signature of the compacted archetype.
+		/// \param rowRemap The new index of every old row of the archetype.
+		/// \return All entities whose archetype index has changed.
+		std::vector<Entity> remapArchetypeIndices(Signature signature, const std::vector<std::optional<size_t>> &rowRemap);
+
+		/// Collect all entities whose components are stored in the archetype of a signature.
+		/// \param signature The signature to look for.
+		/// \return All entities with exactly this signature.
+		std::vector<Entity> getAllEntitiesOfSignature(Signature signature) const;
+
+		/// Collect the entity stored in every row of every archetype in a single pass over all entities. Entities of the
+		/// root archetype have no row and are left out.
+		/// \return The entity of every row by the signature of its archetype. Vacant rows hold no entity and stay 0.
+		std::unordered_map<Signature, std::vector<Entity>> getRowEntities() const;
+
+		/// Fetch the signature of every living entity.
+		const std::unordered_map<Entity, Signature> &getEntitySignatures() const { return entitySignatureMap; }
+
+		/// Fetch how often every entity index has been removed. Indices that have never been removed are left out. An
+		/// index whose generation has changed has been destroyed and recycled in between.
+		const std::unordered_map<Entity, uint32_t> &getEntityGenerations() const { return entityGenerationMap; }
+
+		/// Fetch the version of the signature and archetype index tables. It changes whenever an entity is created,
+		/// removed or moved to another row, so equal versions mean an unchanged structure.
+		uint64_t getStructureVersion() const { return structureVersion; }
+
+		/// Copy the bookkeeping of all entities into a state. The free lists of threads are owned by their threads and are
+		/// not captured, so the reservations have to be collected before, e.g. by collectReservedEntities.
+		/// \param state The state to overwrite. Its memory is reused.
+		void captureState(EntityManagerState &state) const;
+
+		/// Restore the bookkeeping of all entities from a captured state. Entities created after the capture become
+		/// uninitialized again and the free lists and reservations of all threads are dropped. Must not run concurrently
+		/// with reserveEntity.
+		/// \param state The state to restore.
+		void restoreState(const EntityManagerState &state);
+
+		/// Fetch the amount of living entities.
+		size_t getEntityCount() const { return entitySignatureMap.size(); }
+
+		/// Fetch the amount of dead entities that wait for being recycled.
+		size_t getDeadEntityCount() const;
+
+		/// Fetch the amount of entities createEntity can still hand out, recycled and new ones together.
+		size_t getCreatableEntityCount() const;
+
 		std::vector<Entity> getAllActiveEntities() {
 			std::vector<Entity> keys;
 			for (const auto &pair: entityArchetypeIndexMap) {
@@ -53,12 +172,37 @@ class EntityManager {
 		}
 
 	private:
-		size_t nextId;
+		/// The free list and the reservations of a single thread.
+		struct ThreadEntityCache {
+			std::vector<Entity> freeEntities;
+			std::vector<Entity> reservedEntities;
+		};
+
+		std::atomic<size_t> nextId;
+		/// Dead entities are flagged from the moment they are removed until they are handed out again, including the
+		/// time they wait in the free list of a thread, so isAlive never has to look at the lists.
+		EntityDeadFlags deadFlags;
+		std::atomic<size_t> deadEntityCount;
 		std::queue<Entity> deadEntities;
+		mutable std::mutex deadEntitiesMutex;
+		std::vector<std::unique_ptr<ThreadEntityCache>> threadCaches;
+		/// The cache of every thread that has used this manager. A thread that reuses the id of a finished one takes over
+		/// its cache, whose reservations are committed like the ones of any other thread.
+		std::unordered_map<std::thread::id, ThreadEntityCache *> threadCacheMap;
+		const uint64_t managerId;
 		std::unordered_map<Entity, Signature> entitySignatureMap;
 		std::unordered_map<Entity, size_t> entityArchetypeIndexMap;
+		/// Counts the removals of every index. It only ever grows, restoring a state does not rewind it.
+		std::unordered_map<Entity, uint32_t> entityGenerationMap;
+		/// Changes whenever the signature and archetype index tables change. Versions are never reused, so equal
+		/// versions mean equal tables.
+		uint64_t structureVersion;
 
-		std::vector<Entity> getAllEntitiesOfSignature(Signature signature) const;
+		/// Get the cache of the calling thread, creating it on first use.
+		ThreadEntityCache &getThreadCache();
+
+		/// Claim a new entity index that has never been used.
+		std::optional<Entity> claimNewEntity();
 
 		friend class EntityManagerTestFriend;
 		friend class WorldFriendAccessor;
@@ -0,0 +1,143 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_EVENTBUS_HPP
+#define JAREP_EVENTBUS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+#include "threadlookupcache.hpp"
+
+/// Type erased interface of an event channel, so the event bus can publish all channels at once.
+class EventChannelBase {
+	public:
+		virtual ~EventChannelBase() = default;
+
+		/// Make all events sent since the last call readable and drop the events that have been readable until now.
+		virtual void publish() = 0;
+};
+
+/// A channel for events of a single type. Events are written into a buffer of the sending thread, so sending never has
+/// to wait for other threads. The buffers are merged at the sync point, after which all events can be read in bulk.
+/// \tparam T The event type.
+template<class T>
+class EventChannel : public EventChannelBase {
+
+	public:
+		EventChannel() : channelId(nextChannelId.fetch_add(1)) {}
+
+		~EventChannel() override = default;
+
+		/// Send an event. It becomes readable after the next sync point.
+		/// \param event The event to send.
+		void send(const T &event) {
+			getThreadBuffer().push_back(event);
+		}
+
+		/// Send multiple events at once. They become readable after the next sync point.
+		/// \param events The events to send.
+		void send(std::span<const T> events) {
+			auto &buffer = getThreadBuffer();
+			buffer.insert(buffer.end(), events.begin(), events.end());
+		}
+
+		/// Read all events that have been published at the last sync point. The span stays valid until the next sync point.
+		/// \return The published events, grouped by the thread that sent them.
+		[[nodiscard]] std::span<const T> read() const {
+			return std::span<const T>(publishedEvents);
+		}
+
+		/// Make all events sent since the last call readable. Must not be called while events are sent.
+		void publish() override {
+			std::lock_guard lock(threadBufferMutex);
+			publishedEvents.clear();
+			for (const auto &threadBuffer: threadBuffers) {
+				publishedEvents.insert(publishedEvents.end(), threadBuffer->begin(), threadBuffer->end());
+				threadBuffer->clear();
+			}
+		}
+
+	private:
+		static inline std::atomic<uint64_t> nextChannelId = THREAD_LOOKUP_CACHE_EMPTY_ID + 1;
+
+		/// Unique for every channel ever created, so a thread never mistakes a new channel for a destroyed one at the same address.
+		const uint64_t channelId;
+		std::vector<T> publishedEvents;
+		std::vector<std::unique_ptr<std::vector<T>>> threadBuffers;
+		/// The buffer of every thread that has sent to this channel. A thread that reuses the id of a finished one takes
+		/// over its buffer, which the finished thread does not write to anymore.
+		std::unordered_map<std::thread::id, std::vector<T> *> threadBufferMap;
+		std::mutex threadBufferMutex;
+
+		std::vector<T> &getThreadBuffer() {
+			// Every thread caches the buffers of the channels it has sent to last, so the lock is only taken if a thread
+			// alternates between more channels of a type than the cache holds.
+			thread_local ThreadLookupCache<std::vector<T>> cachedBuffers;
+			if (auto cachedBuffer = cachedBuffers.find(channelId)) return *cachedBuffer;
+
+			std::lock_guard lock(threadBufferMutex);
+			auto &threadBuffer = threadBufferMap[std::this_thread::get_id()];
+			if (!threadBuffer) {
+				threadBuffers.push_back(std::make_unique<std::vector<T>>());
+				threadBuffer = threadBuffers.back().get();
+			}
+			cachedBuffers.insert(channelId, threadBuffer);
+			return *threadBuffer;
+		}
+};
+
+/// The event bus holds one channel per event type. Systems communicate through it instead of adding and removing
+/// components, which would migrate entities between archetypes.
+class EventBus {
+
+	public:
+		EventBus() : busId(nextBusId.fetch_add(1)) {}
+
+		~EventBus() = default;
+
+		/// Get the channel of an event type. The channel is created on first access.
+		/// \tparam T The event type.
+		/// \return Reference to the channel, which stays valid as long as the event bus lives.
+		template<class T>
+		EventChannel<T> &getChannel() {
+			// Every thread caches the channels of the buses it has used last, so sending only takes the lock on the first
+			// event of a type or if a thread alternates between more buses than the cache holds.
+			thread_local ThreadLookupCache<EventChannel<T>> cachedChannels;
+			if (auto cachedChannel = cachedChannels.find(busId)) return *cachedChannel;
+
+			std::lock_guard lock(channelMutex);
+			auto &channel = channels[std::type_index(typeid(T))];
+			if (!channel) {
+				channel = std::make_unique<EventChannel<T>>();
+			}
+			auto typedChannel = static_cast<EventChannel<T> *>(channel.get());
+			cachedChannels.insert(busId, typedChannel);
+			return *typedChannel;
+		}
+
+		/// The sync point of all channels. Events sent since the last call become readable.
+		void publish() {
+			std::lock_guard lock(channelMutex);
+			for (auto &channel: channels) {
+				channel.second->publish();
+			}
+		}
+
+	private:
+		static inline std::atomic<uint64_t> nextBusId = THREAD_LOOKUP_CACHE_EMPTY_ID + 1;
+
+		/// Unique for every bus ever created, so a thread never mistakes a new bus for a destroyed one at the same address.
+		const uint64_t busId;
+		std::unordered_map<std::type_index, std::unique_ptr<EventChannelBase>> channels;
+		std::mutex channelMutex;
+};
+
+#endif //JAREP_EVENTBUS_HPP
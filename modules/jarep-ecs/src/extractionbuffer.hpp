@@ -0,0 +1,101 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_EXTRACTIONBUFFER_HPP
+#define JAREP_EXTRACTIONBUFFER_HPP
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/// Hands the data extracted from a world, e.g. the render list of a frame, from the simulation thread to a consumer
+/// thread. The producer fills the back list while the consumer reads the front list, so the simulation of the next frame
+/// overlaps with the consumption of the last one. Publishing swaps both lists and only waits while the consumer is still
+/// reading the front list, waitUntilPickedUp keeps the producer from running further ahead. The lists keep their memory,
+/// so extracting the same amount of items every frame does not allocate.
+/// \tparam T The item type of the lists.
+template<class T>
+class ExtractionBuffer {
+
+	public:
+		/// Get the back list to fill with the items of the next frame. The list is cleared but keeps its capacity. Must
+		/// only be called by the producer thread.
+		std::vector<T> &getBackList() {
+			auto &backList = lists[1 - frontIndex];
+			backList.clear();
+			return backList;
+		}
+
+		/// Make the back list the front list, so the consumer reads it from now on. Waits until the consumer has finished
+		/// reading the previous front list. Must only be called by the producer thread.
+		void publish() {
+			std::unique_lock<std::mutex> lock(mutex);
+			stateChanged.wait(lock, [this]() { return !reading; });
+			frontIndex = 1 - frontIndex;
+			publishedFrameCount++;
+		}
+
+		/// Wait until the consumer has started reading the last published list, so the producer stays at most one frame
+		/// ahead of the consumer. Must only be called by the producer thread.
+		/// \return False if the buffer has been closed.
+		bool waitUntilPickedUp() {
+			std::unique_lock<std::mutex> lock(mutex);
+			stateChanged.wait(lock, [this]() { return pickedUpFrameCount == publishedFrameCount || closed; });
+			return !closed;
+		}
+
+		/// Release the producer from waiting for lists to be picked up, e.g. because the consumer shuts down.
+		void close() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				closed = true;
+			}
+			stateChanged.notify_all();
+		}
+
+		/// Read the front list, i.e. the items of the last published frame. The producer can fill the back list meanwhile
+		/// but cannot publish before the callback has returned. Must only be called by the consumer thread.
+		/// \param callback Callable receiving a const std::vector<T> &.
+		/// \return The amount of frames published before the read list, zero if nothing has been published yet.
+		template<class Callback>
+		uint64_t read(Callback &&callback) {
+			size_t readIndex = 0;
+			uint64_t readFrameCount = 0;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				reading = true;
+				readIndex = frontIndex;
+				readFrameCount = publishedFrameCount;
+				pickedUpFrameCount = publishedFrameCount;
+			}
+			stateChanged.notify_all();
+			callback(static_cast<const std::vector<T> &>(lists[readIndex]));
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				reading = false;
+			}
+			stateChanged.notify_all();
+			return readFrameCount;
+		}
+
+		/// Fetch the amount of frames that have been published.
+		[[nodiscard]] uint64_t getPublishedFrameCount() const {
+			std::lock_guard<std::mutex> lock(mutex);
+			return publishedFrameCount;
+		}
+
+	private:
+		std::array<std::vector<T>, 2> lists;
+		size_t frontIndex = 0;
+		bool reading = false;
+		bool closed = false;
+		uint64_t publishedFrameCount = 0;
+		uint64_t pickedUpFrameCount = 0;
+		mutable std::mutex mutex;
+		std::condition_variable stateChanged;
+};
+
+#endif //JAREP_EXTRACTIONBUFFER_HPP
@@ -0,0 +1,97 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#include "mappedlevel.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedLevel::~MappedLevel() {
+	if (mappedData != nullptr) {
+		munmap(mappedData, mappedSize);
+	}
+	archetypes.clear();
+}
+
+std::optional<std::unique_ptr<MappedLevel>> MappedLevel::open(const std::string &path) {
+	int fileDescriptor = ::open(path.c_str(), O_RDONLY);
+	if (fileDescriptor < 0) return std::nullopt;
+
+	struct stat fileStatus{};
+	if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size == 0) {
+		close(fileDescriptor);
+		return std::nullopt;
+	}
+
+	auto level = std::unique_ptr<MappedLevel>(new MappedLevel());
+	level->mappedSize = static_cast<size_t>(fileStatus.st_size);
+	void *mappedData = mmap(nullptr, level->mappedSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	// The mapping keeps its own reference to the file, so the descriptor is not needed anymore.
+	close(fileDescriptor);
+	if (mappedData == MAP_FAILED) return std::nullopt;
+	level->mappedData = mappedData;
+
+	if (!level->readTableOfContents()) return std::nullopt;
+	return std::make_optional(std::move(level));
+}
+
+std::optional<std::span<const std::byte>>
+MappedLevel::getColumn(size_t archetypeIndex, const std::string &componentName) const {
+	if (archetypeIndex >= archetypes.size()) return std::nullopt;
+
+	const auto &archetype = archetypes[archetypeIndex];
+	for (size_t i = 0; i < archetype.componentNames.size(); ++i) {
+		if (archetype.componentNames[i] == componentName) return std::make_optional(archetype.columns[i]);
+	}
+	return std::nullopt;
+}
+
+bool MappedLevel::readTableOfContents() {
+	const auto *data = static_cast<const std::byte *>(mappedData);
+	size_t cursor = 0;
+
+	// Every read is checked against the size of the file, so a truncated file can never be read out of bounds.
+	auto read = [&](void *destination, size_t size) {
+		if (size > mappedSize - cursor) return false;
+		std::memcpy(destination, data + cursor, size);
+		cursor += size;
+		return true;
+	};
+
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint32_t archetypeCount = 0;
+	if (!read(&magic, sizeof(magic)) || !read(&version, sizeof(version)) ||
+	    !read(&archetypeCount, sizeof(archetypeCount))) {
+		return false;
+	}
+	if (magic != LEVEL_FILE_MAGIC || version != LEVEL_FILE_VERSION) return false;
+
+	for (uint32_t archetypeIndex = 0; archetypeIndex < archetypeCount; ++archetypeIndex) {
+		ArchetypeEntry archetype;
+		uint32_t componentCount = 0;
+		if (!read(&componentCount, sizeof(componentCount))) return false;
+		for (uint32_t i = 0; i < componentCount; ++i) {
+			uint32_t nameLength = 0;
+			if (!read(&nameLength, sizeof(nameLength)) || nameLength > mappedSize - cursor) return false;
+			auto name = std::string(nameLength, '\0');
+			if (!read(name.data(), nameLength)) return false;
+			archetype.componentNames.push_back(std::move(name));
+		}
+
+		if (!read(&archetype.rowCount, sizeof(archetype.rowCount))) return false;
+		for (uint32_t i = 0; i < componentCount; ++i) {
+			uint64_t offset = 0;
+			uint64_t size = 0;
+			if (!read(&offset, sizeof(offset)) || !read(&size, sizeof(size))) return false;
+			if (offset % LEVEL_COLUMN_ALIGNMENT != 0 || offset > mappedSize || size > mappedSize - offset) return false;
+			archetype.columns.emplace_back(data + offset, size);
+		}
+		archetypes.push_back(std::move(archetype));
+	}
+	return true;
+}
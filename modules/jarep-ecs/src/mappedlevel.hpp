@@ -0,0 +1,75 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_MAPPEDLEVEL_HPP
+#define JAREP_MAPPEDLEVEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+/// Identifies a level file. The values are stored in the native byte order of the machine that wrote them.
+const uint32_t LEVEL_FILE_MAGIC = 0x4C56454A; // "JEVL"
+const uint32_t LEVEL_FILE_VERSION = 1;
+
+/// The columns of a level file start at multiples of this value. 16 KiB is the largest page size of all supported
+/// platforms, so every column starts on its own page.
+const uint64_t LEVEL_COLUMN_ALIGNMENT = 16384;
+
+/// A level file mapped read-only into memory. A level file contains the packed columns of plain components, which can be
+/// read in place without copying them into a buffer first. The mapping stays valid as long as the instance lives.
+class MappedLevel {
+
+	public:
+		/// An archetype stored in the level file.
+		struct ArchetypeEntry {
+			std::vector<std::string> componentNames;
+			uint64_t rowCount = 0;
+			/// The packed column of every component, ordered like the component names.
+			std::vector<std::span<const std::byte>> columns;
+		};
+
+		~MappedLevel();
+
+		MappedLevel(const MappedLevel &) = delete;
+
+		MappedLevel &operator=(const MappedLevel &) = delete;
+
+		/// Map a level file into memory and read its table of contents.
+		/// \param path The path of the level file.
+		/// \return The mapped level or nullopt if the file cannot be mapped or is not a valid level file.
+		static std::optional<std::unique_ptr<MappedLevel>> open(const std::string &path);
+
+		/// Get all archetypes stored in the level file.
+		[[nodiscard]] const std::vector<ArchetypeEntry> &getArchetypes() const { return archetypes; }
+
+		/// Get the packed column of a component inside an archetype.
+		/// \param archetypeIndex The index of the archetype in the level file.
+		/// \param componentName The name of the component codec.
+		/// \return The mapped bytes of the column or nullopt if the archetype does not contain the component.
+		[[nodiscard]] std::optional<std::span<const std::byte>>
+		getColumn(size_t archetypeIndex, const std::string &componentName) const;
+
+	private:
+		MappedLevel() = default;
+
+		void *mappedData = nullptr;
+		size_t mappedSize = 0;
+		std::vector<ArchetypeEntry> archetypes;
+
+		bool readTableOfContents();
+};
+
+/// Round an offset inside a level file up to the start of the next column.
+/// \param offset The offset to round up.
+/// \return The aligned offset.
+inline uint64_t alignLevelOffset(uint64_t offset) {
+	return (offset + LEVEL_COLUMN_ALIGNMENT - 1) / LEVEL_COLUMN_ALIGNMENT * LEVEL_COLUMN_ALIGNMENT;
+}
+
+#endif //JAREP_MAPPEDLEVEL_HPP
@@ -0,0 +1,83 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#include "rowbitmask.hpp"
+
+#include <bit>
+
+void RowBitmask::set(size_t row, bool value) {
+	size_t wordIndex = row / BITS_PER_WORD;
+	uint64_t bit = uint64_t(1) << (row % BITS_PER_WORD);
+	if (!value) {
+		if (wordIndex < words.size()) words[wordIndex] &= ~bit;
+		return;
+	}
+
+	if (wordIndex >= words.size()) words.resize(wordIndex + 1, 0);
+	words[wordIndex] |= bit;
+}
+
+void RowBitmask::setRange(size_t firstRow, size_t rowCount) {
+	if (rowCount == 0) return;
+	size_t firstWord = firstRow / BITS_PER_WORD;
+	size_t lastRow = firstRow + rowCount - 1;
+	size_t lastWord = lastRow / BITS_PER_WORD;
+	if (words.size() <= lastWord) words.resize(lastWord + 1, 0);
+
+	// Whole words are filled at once, only the first and the last word are masked.
+	for (size_t wordIndex = firstWord; wordIndex <= lastWord; ++wordIndex) {
+		uint64_t mask = ~uint64_t(0);
+		if (wordIndex == firstWord) mask &= ~uint64_t(0) << (firstRow % BITS_PER_WORD);
+		if (wordIndex == lastWord) mask &= ~uint64_t(0) >> (BITS_PER_WORD - 1 - lastRow % BITS_PER_WORD);
+		words[wordIndex] |= mask;
+	}
+}
+
+bool RowBitmask::test(size_t row) const {
+	return (getWord(row / BITS_PER_WORD) >> (row % BITS_PER_WORD)) & 1;
+}
+
+size_t RowBitmask::count() const {
+	size_t setBits = 0;
+	for (const uint64_t word: words) {
+		setBits += std::popcount(word);
+	}
+	return setBits;
+}
+
+void RowBitmask::erase(size_t row) {
+	size_t wordIndex = row / BITS_PER_WORD;
+	if (wordIndex >= words.size()) return;
+
+	// Within the word of the erased row only the bits above it move down, every following word moves down by one bit
+	// and passes its lowest bit on to the highest bit of the previous word.
+	size_t bitIndex = row % BITS_PER_WORD;
+	uint64_t lowerBits = bitIndex == 0 ? 0 : words[wordIndex] & ((uint64_t(1) << bitIndex) - 1);
+	uint64_t upperBits = bitIndex == BITS_PER_WORD - 1 ? 0 : (words[wordIndex] >> (bitIndex + 1)) << bitIndex;
+	words[wordIndex] = lowerBits | upperBits;
+	for (size_t i = wordIndex + 1; i < words.size(); ++i) {
+		words[i - 1] |= (words[i] & 1) << (BITS_PER_WORD - 1);
+		words[i] >>= 1;
+	}
+}
+
+void RowBitmask::insert(const RowBitmask &other, size_t firstRow, size_t rowCount) {
+	for (size_t wordIndex = 0; wordIndex * BITS_PER_WORD < rowCount && wordIndex < other.words.size(); ++wordIndex) {
+		uint64_t word = other.words[wordIndex];
+		while (word != 0) {
+			size_t bitIndex = std::countr_zero(word);
+			size_t row = wordIndex * BITS_PER_WORD + bitIndex;
+			if (row >= rowCount) break;
+			set(firstRow + row, true);
+			word &= word - 1;
+		}
+	}
+}
+
+void RowBitmask::merge(const RowBitmask &other) {
+	if (words.size() < other.words.size()) words.resize(other.words.size(), 0);
+	for (size_t wordIndex = 0; wordIndex < other.words.size(); ++wordIndex) {
+		words[wordIndex] |= other.words[wordIndex];
+	}
+}
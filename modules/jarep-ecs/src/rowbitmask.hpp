@@ -0,0 +1,58 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_ROWBITMASK_HPP
+#define JAREP_ROWBITMASK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// One bit per row of a component column, packed into 64 bit words so queries can skip whole words of rows at once.
+/// Rows behind the stored words read as unset, so the mask only grows when a bit is set.
+class RowBitmask {
+
+	public:
+		static constexpr size_t BITS_PER_WORD = 64;
+
+		/// Set or clear the bit of a row.
+		void set(size_t row, bool value);
+
+		/// Set the bits of a range of rows.
+		/// \param firstRow The first row of the range.
+		/// \param rowCount The amount of rows in the range.
+		void setRange(size_t firstRow, size_t rowCount);
+
+		/// Check the bit of a row.
+		[[nodiscard]] bool test(size_t row) const;
+
+		/// Get the word holding the bits of the rows [wordIndex * 64, wordIndex * 64 + 64).
+		[[nodiscard]] uint64_t getWord(size_t wordIndex) const {
+			return wordIndex < words.size() ? words[wordIndex] : 0;
+		}
+
+		/// Fetch the amount of set bits.
+		[[nodiscard]] size_t count() const;
+
+		/// Remove the bit of a row and move the bits of all following rows one row down, like erasing the row does.
+		void erase(size_t row);
+
+		/// Copy the bits of another mask behind the given row.
+		/// \param other The mask to copy the bits from.
+		/// \param firstRow The row the first bit of the other mask is written to.
+		/// \param rowCount The amount of rows to copy.
+		void insert(const RowBitmask &other, size_t firstRow, size_t rowCount);
+
+		/// Set the bits of all rows whose bit is set in another mask.
+		/// \param other The mask to merge into this one.
+		void merge(const RowBitmask &other);
+
+		/// Remove all bits.
+		void clear() { words.clear(); }
+
+	private:
+		std::vector<uint64_t> words;
+};
+
+#endif //JAREP_ROWBITMASK_HPP
@@ -0,0 +1,212 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_SERIALIZATION_HPP
+#define JAREP_SERIALIZATION_HPP
+
+#include <algorithm>
+#include <any>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "component.hpp"
+#include "componentInstanceCollection.hpp"
+#include "componentmanager.hpp"
+#include "entity.hpp"
+
+class World;
+
+/// Identifies a binary world snapshot. The values are stored in the native byte order of the machine that wrote them.
+const uint32_t WORLD_SNAPSHOT_MAGIC = 0x5343454A; // "JECS"
+const uint32_t WORLD_SNAPSHOT_VERSION = 1;
+
+/// The amount of bytes a plain column is read in at most at once. Row counts are read from the stream, so the buffer only
+/// grows with the data that has actually arrived instead of trusting the count.
+const size_t SERIALIZATION_READ_BLOCK_SIZE = 64 * 1024;
+
+/// Write a trivially copyable value to a binary stream.
+/// \param stream The stream to write to.
+/// \param value The value to write.
+template<class T>
+void writeBinary(std::ostream &stream, const T &value) {
+	static_assert(std::is_trivially_copyable_v<T>);
+	stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/// Read a trivially copyable value from a binary stream.
+/// \param stream The stream to read from.
+/// \param value The value to overwrite with the read data.
+/// \return True if the value could be read completely.
+template<class T>
+bool readBinary(std::istream &stream, T &value) {
+	static_assert(std::is_trivially_copyable_v<T>);
+	stream.read(reinterpret_cast<char *>(&value), sizeof(T));
+	return !stream.fail();
+}
+
+/// A codec describes how the instances of one component type are written to and read from a binary stream. Codecs work
+/// on whole component collections, so each column of an archetype is handled in one go.
+struct ComponentCodec {
+	/// The stable name of the component type inside the binary data. Type indices differ between builds.
+	std::string name;
+
+	/// Register the component type in a component manager.
+	std::function<void(ComponentManager &)> registerComponent;
+
+	/// Create an empty collection for the component type.
+	std::function<std::unique_ptr<ComponentInstanceCollection>()> createCollection;
+
+	/// Write the given rows of a collection to a stream.
+	std::function<void(ComponentInstanceCollection &, const std::vector<size_t> &, std::ostream &)> writeColumn;
+
+	/// Read a given amount of rows from a stream and append them to a collection. Returns false if the stream ended early.
+	std::function<bool(ComponentInstanceCollection &, size_t, std::istream &)> readColumn;
+
+	/// The amount of bytes a single packed instance occupies. Zero if the component is not plain and cannot be packed.
+	size_t packedSize = 0;
+
+	/// Pack the given rows of a collection into a buffer of rows * packedSize bytes. Only set for plain components.
+	std::function<void(ComponentInstanceCollection &, const std::vector<size_t> &, std::byte *)> packColumn;
+
+	/// Append a given amount of packed rows from a buffer to a collection. Only set for plain components.
+	std::function<void(ComponentInstanceCollection &, size_t, const std::byte *)> unpackColumn;
+
+	/// Overwrite the instance of an existing row with a packed instance. Only set for plain components.
+	std::function<void(ComponentInstanceCollection &, size_t, const std::byte *)> unpackRow;
+
+	/// Overwrite the instance of an existing row with an instance read from a stream. Returns false if the stream ended early.
+	std::function<bool(ComponentInstanceCollection &, size_t, std::istream &)> readRow;
+
+	/// Add a default constructed instance of the component type to an entity. Set when the codec is registered in a world.
+	std::function<void(World &, Entity)> addToEntity;
+
+	/// Remove the instance of the component type from an entity. Set when the codec is registered in a world.
+	std::function<void(World &, Entity)> removeFromEntity;
+};
+
+/// Create a codec which has all properties of a component type besides reading and writing the actual columns.
+template<class T>
+ComponentCodec createCodecBase(std::string name) {
+	ComponentCodec codec;
+	codec.name = std::move(name);
+	codec.registerComponent = [](ComponentManager &componentManager) {
+		componentManager.registerComponent<T>();
+	};
+	codec.createCollection = []() -> std::unique_ptr<ComponentInstanceCollection> {
+		return std::make_unique<InstanceCollection<T>>();
+	};
+	return codec;
+}
+
+/// Create a codec for a plain component. The members of all rows are packed into one buffer, which is written to and read
+/// from the stream as a whole.
+/// \tparam T The plain component type.
+/// \param name The stable name of the component type.
+template<PlainComponent T>
+ComponentCodec createPlainCodec(std::string name) {
+	auto codec = createCodecBase<T>(std::move(name));
+	codec.packedSize = plainDataSize<T>();
+	codec.packColumn = [](ComponentInstanceCollection &collection, const std::vector<size_t> &rows, std::byte *buffer) {
+		const auto &componentList = std::any_cast<std::reference_wrapper<const std::vector<std::shared_ptr<T>>>>(
+				collection.as_any_const()).get();
+		for (size_t i = 0; i < rows.size(); ++i) {
+			readPlainData(*componentList[rows[i]], buffer + i * plainDataSize<T>());
+		}
+	};
+	codec.unpackColumn = [](ComponentInstanceCollection &collection, size_t rowCount, const std::byte *buffer) {
+		auto &componentList = std::any_cast<std::reference_wrapper<std::vector<std::shared_ptr<T>>>>(collection.as_any()).get();
+		componentList.reserve(componentList.size() + rowCount);
+		for (size_t i = 0; i < rowCount; ++i) {
+			auto component = createComponentInstance<T>();
+			writePlainData(*component, buffer + i * plainDataSize<T>());
+			componentList.push_back(std::move(component));
+		}
+	};
+	codec.unpackRow = [](ComponentInstanceCollection &collection, size_t row, const std::byte *buffer) {
+		auto &componentList = std::any_cast<std::reference_wrapper<std::vector<std::shared_ptr<T>>>>(collection.as_any()).get();
+		writePlainData(*componentList[row], buffer);
+	};
+	codec.writeColumn = [packColumn = codec.packColumn](ComponentInstanceCollection &collection,
+	                                                    const std::vector<size_t> &rows, std::ostream &stream) {
+		auto buffer = std::vector<std::byte>(rows.size() * plainDataSize<T>());
+		packColumn(collection, rows, buffer.data());
+		stream.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+	};
+	codec.readColumn = [unpackColumn = codec.unpackColumn](ComponentInstanceCollection &collection, size_t rowCount,
+	                                                       std::istream &stream) {
+		constexpr size_t rowSize = std::max<size_t>(plainDataSize<T>(), 1);
+		if (rowCount > std::numeric_limits<size_t>::max() / rowSize) return false;
+
+		constexpr size_t rowsPerBlock = std::max<size_t>(SERIALIZATION_READ_BLOCK_SIZE / rowSize, 1);
+		auto buffer = std::vector<std::byte>();
+		for (size_t readRowCount = 0; readRowCount < rowCount;) {
+			size_t blockRowCount = std::min(rowsPerBlock, rowCount - readRowCount);
+			buffer.resize(blockRowCount * plainDataSize<T>());
+			stream.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+			if (stream.fail()) return false;
+			unpackColumn(collection, blockRowCount, buffer.data());
+			readRowCount += blockRowCount;
+		}
+		return true;
+	};
+	codec.readRow = [unpackRow = codec.unpackRow](ComponentInstanceCollection &collection, size_t row, std::istream &stream) {
+		auto buffer = std::vector<std::byte>(plainDataSize<T>());
+		stream.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+		if (stream.fail()) return false;
+		unpackRow(collection, row, buffer.data());
+		return true;
+	};
+	return codec;
+}
+
+/// Create a codec for a component that needs custom handling, e.g. because it owns heap memory.
+/// \tparam T The component type.
+/// \param name The stable name of the component type.
+/// \param write Function that writes a single component instance to a stream.
+/// \param read Function that reads a single component instance from a stream into a default constructed instance.
+template<class T>
+ComponentCodec createCustomCodec(std::string name, std::function<void(const T &, std::ostream &)> write,
+                                 std::function<void(std::istream &, T &)> read) {
+	auto codec = createCodecBase<T>(std::move(name));
+	codec.writeColumn = [write](ComponentInstanceCollection &collection, const std::vector<size_t> &rows,
+	                            std::ostream &stream) {
+		const auto &componentList = std::any_cast<std::reference_wrapper<const std::vector<std::shared_ptr<T>>>>(
+				collection.as_any_const()).get();
+		for (const size_t row: rows) {
+			write(*componentList[row], stream);
+		}
+	};
+	codec.readColumn = [read](ComponentInstanceCollection &collection, size_t rowCount, std::istream &stream) {
+		// The row count is not reserved up front, it comes from the stream and may be corrupt.
+		auto &componentList = std::any_cast<std::reference_wrapper<std::vector<std::shared_ptr<T>>>>(collection.as_any()).get();
+		for (size_t i = 0; i < rowCount; ++i) {
+			auto component = createComponentInstance<T>();
+			read(stream, *component);
+			if (stream.fail()) return false;
+			componentList.push_back(std::move(component));
+		}
+		return true;
+	};
+	codec.readRow = [read](ComponentInstanceCollection &collection, size_t row, std::istream &stream) {
+		auto &componentList = std::any_cast<std::reference_wrapper<std::vector<std::shared_ptr<T>>>>(collection.as_any()).get();
+		auto component = createComponentInstance<T>();
+		read(stream, *component);
+		if (stream.fail()) return false;
+		// The instance is kept if possible, as systems and callers may still hold it.
+		if constexpr (std::is_move_assignable_v<T>) {
+			*componentList[row] = std::move(*component);
+		} else {
+			componentList[row] = std::move(component);
+		}
+		return true;
+	};
+	return codec;
+}
+
+#endif //JAREP_SERIALIZATION_HPP
@@ -0,0 +1,200 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_SHAREDCOMPONENTSTORE_HPP
+#define JAREP_SHAREDCOMPONENTSTORE_HPP
+
+#include <concepts>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "component.hpp"
+#include "entity.hpp"
+
+/// A shared component holds a value that many entities have in common, like a material or a team. Each distinct value is
+/// stored once and values are told apart by comparing them.
+template<class T>
+concept SharedComponent = std::is_base_of_v<Component, T> && std::equality_comparable<T>;
+
+/// Shared components with a std::hash specialization find the group of a value through a hash map. All others compare
+/// the value against every group, which is only suitable for a few dozen distinct values.
+template<class T>
+concept HashableSharedComponent = SharedComponent<T> && requires(const T &value) {
+	{ std::hash<T>{}(value) } -> std::convertible_to<size_t>;
+};
+
+/// Type independent interface of the shared component stores of a world.
+class SharedComponentStoreBase {
+	public:
+		virtual ~SharedComponentStoreBase() = default;
+
+		/// Create an empty store for the same component type.
+		virtual std::unique_ptr<SharedComponentStoreBase> createNewAndEmpty() = 0;
+
+		/// Remove an entity from its group.
+		/// \param entity -> The entity to remove.
+		/// \return True if the entity had a value in this store.
+		virtual bool remove(Entity entity) = 0;
+
+		/// Move the value of an entity to another store of the same component type, e.g. of another world.
+		/// \param entity -> The entity whose value is moved. It is removed from this store.
+		/// \param target -> The store to move the value to.
+		/// \param targetEntity -> The entity the value is assigned to in the target store.
+		virtual void moveEntity(Entity entity, SharedComponentStoreBase &target, Entity targetEntity) = 0;
+
+		/// Make another store of the same component type an exact copy of this one. The values are immutable and shared
+		/// between both stores.
+		/// \param target -> The store to overwrite.
+		virtual void copyInto(SharedComponentStoreBase &target) const = 0;
+};
+
+/// Stores every distinct value of a shared component once and groups the entities by value, so all entities with the
+/// same value can be processed together without a lookup per entity. Finding the group of a value is a hash lookup for
+/// HashableSharedComponent types and a scan over all groups otherwise.
+template<SharedComponent T>
+class SharedComponentStore : public SharedComponentStoreBase {
+
+	public:
+		std::unique_ptr<SharedComponentStoreBase> createNewAndEmpty() override {
+			return std::make_unique<SharedComponentStore<T>>();
+		}
+
+		/// Assign a value to an entity. The entity joins the group of an equal value or starts a new group.
+		/// \param entity -> The entity to assign the value to.
+		/// \param value -> The value to assign.
+		void set(Entity entity, const T &value) {
+			auto groupIndex = findGroup(value);
+			if (!groupIndex.has_value()) groupIndex = createGroup(std::make_shared<const T>(value));
+			assignGroup(entity, groupIndex.value());
+		}
+
+		bool remove(Entity entity) override {
+			auto entityGroupResult = entityGroups.find(entity);
+			if (entityGroupResult == entityGroups.end()) return false;
+
+			// The order inside a group does not matter, so the entity is swapped with the last one of its group.
+			auto [groupIndex, position] = entityGroupResult->second;
+			auto &group = groups[groupIndex];
+			Entity lastEntity = group.entities.back();
+			group.entities[position] = lastEntity;
+			entityGroups[lastEntity].second = position;
+			group.entities.pop_back();
+			entityGroups.erase(entity);
+
+			// Empty groups release their value and their slot is reused by the next new value.
+			if (group.entities.empty()) {
+				if constexpr (HashableSharedComponent<T>) eraseGroupHash(groupIndex);
+				group.value.reset();
+				freeGroups.push_back(groupIndex);
+			}
+			return true;
+		}
+
+		void moveEntity(Entity entity, SharedComponentStoreBase &target, Entity targetEntity) override {
+			auto value = get(entity);
+			if (!value.has_value()) return;
+
+			auto &targetStore = static_cast<SharedComponentStore<T> &>(target);
+			auto groupIndex = targetStore.findGroup(*value.value());
+			if (!groupIndex.has_value()) groupIndex = targetStore.createGroup(value.value());
+			targetStore.assignGroup(targetEntity, groupIndex.value());
+			remove(entity);
+		}
+
+		void copyInto(SharedComponentStoreBase &target) const override {
+			auto &targetStore = static_cast<SharedComponentStore<T> &>(target);
+			targetStore.groups = groups;
+			targetStore.freeGroups = freeGroups;
+			targetStore.entityGroups = entityGroups;
+			targetStore.groupsByHash = groupsByHash;
+		}
+
+		/// Get the value of an entity.
+		/// \param entity -> The entity whose value is requested.
+		/// \return The value, shared by all entities of the group, or nullopt if the entity has no value.
+		std::optional<std::shared_ptr<const T>> get(Entity entity) const {
+			auto entityGroupResult = entityGroups.find(entity);
+			if (entityGroupResult == entityGroups.end()) return std::nullopt;
+			return std::make_optional(groups[entityGroupResult->second.first].value);
+		}
+
+		/// Call a function once per distinct value with all entities that share it.
+		/// \param callback -> Callable receiving the value as const T & and the entities as std::span<const Entity>.
+		template<class Callback>
+		void forEachGroup(Callback &&callback) const {
+			for (const auto &group: groups) {
+				if (group.entities.empty()) continue;
+				callback(*group.value, std::span<const Entity>(group.entities));
+			}
+		}
+
+		/// Fetch the amount of distinct values.
+		[[nodiscard]] size_t getGroupCount() const { return groups.size() - freeGroups.size(); }
+
+	private:
+		struct Group {
+			std::shared_ptr<const T> value;
+			std::vector<Entity> entities;
+		};
+
+		std::vector<Group> groups;
+		std::vector<size_t> freeGroups;
+		/// The group of every entity and its position in the entity list of the group.
+		std::unordered_map<Entity, std::pair<size_t, size_t>> entityGroups;
+		/// The groups by the hash of their value. Only used for HashableSharedComponent types.
+		std::unordered_multimap<size_t, size_t> groupsByHash;
+
+		std::optional<size_t> findGroup(const T &value) const {
+			if constexpr (HashableSharedComponent<T>) {
+				auto [first, last] = groupsByHash.equal_range(std::hash<T>{}(value));
+				for (auto hashGroup = first; hashGroup != last; ++hashGroup) {
+					if (*groups[hashGroup->second].value == value) return std::make_optional(hashGroup->second);
+				}
+				return std::nullopt;
+			}
+			for (size_t groupIndex = 0; groupIndex < groups.size(); ++groupIndex) {
+				if (groups[groupIndex].value && *groups[groupIndex].value == value) return std::make_optional(groupIndex);
+			}
+			return std::nullopt;
+		}
+
+		size_t createGroup(std::shared_ptr<const T> value) {
+			size_t groupIndex = groups.size();
+			if (!freeGroups.empty()) {
+				groupIndex = freeGroups.back();
+				freeGroups.pop_back();
+				groups[groupIndex].value = std::move(value);
+			} else {
+				groups.push_back(Group{std::move(value), {}});
+			}
+			if constexpr (HashableSharedComponent<T>) {
+				groupsByHash.emplace(std::hash<T>{}(*groups[groupIndex].value), groupIndex);
+			}
+			return groupIndex;
+		}
+
+		void eraseGroupHash(size_t groupIndex) requires HashableSharedComponent<T> {
+			auto [first, last] = groupsByHash.equal_range(std::hash<T>{}(*groups[groupIndex].value));
+			for (auto hashGroup = first; hashGroup != last; ++hashGroup) {
+				if (hashGroup->second != groupIndex) continue;
+				groupsByHash.erase(hashGroup);
+				return;
+			}
+		}
+
+		void assignGroup(Entity entity, size_t groupIndex) {
+			auto entityGroupResult = entityGroups.find(entity);
+			if (entityGroupResult != entityGroups.end() && entityGroupResult->second.first == groupIndex) return;
+
+			remove(entity);
+			groups[groupIndex].entities.push_back(entity);
+			entityGroups[entity] = std::make_pair(groupIndex, groups[groupIndex].entities.size() - 1);
+		}
+};
+
+#endif //JAREP_SHAREDCOMPONENTSTORE_HPP
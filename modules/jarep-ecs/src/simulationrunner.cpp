@@ -0,0 +1,95 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#include "simulationrunner.hpp"
+
+SimulationRunner::SimulationRunner(std::chrono::nanoseconds tickInterval) {
+	this->tickInterval = tickInterval;
+	running = false;
+	stopRequested = false;
+}
+
+SimulationRunner::~SimulationRunner() {
+	stop();
+}
+
+std::optional<size_t> SimulationRunner::addWorld(std::shared_ptr<World> world) {
+	if (running) return std::nullopt;
+
+	worlds.push_back(std::move(world));
+	std::lock_guard<std::mutex> lock(statisticsMutex);
+	statistics.emplace_back();
+	return std::make_optional(worlds.size() - 1);
+}
+
+bool SimulationRunner::start(std::optional<uint64_t> tickLimit) {
+	if (running) return false;
+
+	// Threads of a previous run that reached their tick limit have to be joined before they can be replaced.
+	for (auto &thread: threads) {
+		if (thread.joinable()) thread.join();
+	}
+	threads.clear();
+
+	running = true;
+	stopRequested = false;
+	for (size_t worldIndex = 0; worldIndex < worlds.size(); ++worldIndex) {
+		threads.emplace_back(&SimulationRunner::runWorld, this, worldIndex, tickLimit);
+	}
+	return true;
+}
+
+void SimulationRunner::stop() {
+	stopRequested = true;
+	wait();
+}
+
+void SimulationRunner::wait() {
+	for (auto &thread: threads) {
+		if (thread.joinable()) thread.join();
+	}
+	running = false;
+}
+
+std::vector<TickStatistics> SimulationRunner::getStatistics() const {
+	std::lock_guard<std::mutex> lock(statisticsMutex);
+	return statistics;
+}
+
+void SimulationRunner::runWorld(size_t worldIndex, std::optional<uint64_t> tickLimit) {
+	auto &world = worlds[worldIndex];
+	auto nextTickTime = std::chrono::steady_clock::now();
+	uint64_t tickCount = 0;
+
+	while (!stopRequested && (!tickLimit.has_value() || tickCount < tickLimit.value())) {
+		auto tickStartTime = std::chrono::steady_clock::now();
+		world->tick(tickInterval);
+		auto tickDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - tickStartTime);
+		tickCount++;
+
+		// A world that has fallen behind by more than a whole tick drops the missed ticks instead of running them
+		// back to back, so a single slow tick does not cause a burst of catch-up ticks.
+		nextTickTime += tickInterval;
+		uint64_t skippedTicks = 0;
+		auto now = std::chrono::steady_clock::now();
+		if (now - nextTickTime > tickInterval) {
+			skippedTicks = static_cast<uint64_t>((now - nextTickTime) / tickInterval);
+			nextTickTime += tickInterval * skippedTicks;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(statisticsMutex);
+			auto &worldStatistics = statistics[worldIndex];
+			worldStatistics.tickCount++;
+			if (tickDuration > tickInterval) worldStatistics.overrunCount++;
+			worldStatistics.skippedTickCount += skippedTicks;
+			worldStatistics.minTickDuration = std::min(worldStatistics.minTickDuration, tickDuration);
+			worldStatistics.maxTickDuration = std::max(worldStatistics.maxTickDuration, tickDuration);
+			worldStatistics.totalTickDuration += tickDuration;
+		}
+
+		std::this_thread::sleep_until(nextTickTime);
+	}
+}
@@ -0,0 +1,81 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_SIMULATIONRUNNER_HPP
+#define JAREP_SIMULATIONRUNNER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "world.hpp"
+
+/// Tick time statistics of a single world driven by a simulation runner.
+struct TickStatistics {
+	/// The amount of ticks that have been run.
+	uint64_t tickCount = 0;
+	/// The amount of ticks that took longer than the tick interval.
+	uint64_t overrunCount = 0;
+	/// The amount of ticks that have been dropped to catch up after overruns.
+	uint64_t skippedTickCount = 0;
+	std::chrono::nanoseconds minTickDuration = std::chrono::nanoseconds::max();
+	std::chrono::nanoseconds maxTickDuration = std::chrono::nanoseconds(0);
+	std::chrono::nanoseconds totalTickDuration = std::chrono::nanoseconds(0);
+
+	/// Get the mean duration of all ticks.
+	[[nodiscard]] std::chrono::nanoseconds getAverageTickDuration() const {
+		return tickCount == 0 ? std::chrono::nanoseconds(0) : totalTickDuration / static_cast<int64_t>(tickCount);
+	}
+};
+
+/// Drives worlds with a fixed tick rate without any window or renderer, e.g. on a dedicated simulation server. Every
+/// world runs on its own thread, so the worlds must not share systems or components.
+class SimulationRunner {
+
+	public:
+		/// Create a runner without any worlds.
+		/// \param tickInterval The time between the starts of two ticks, which is also passed to every tick.
+		explicit SimulationRunner(std::chrono::nanoseconds tickInterval);
+
+		~SimulationRunner();
+
+		/// Add a world to the runner. Worlds can only be added while the runner is stopped.
+		/// \param world The world to drive.
+		/// \return The index of the world in the statistics or nullopt if the runner is running.
+		std::optional<size_t> addWorld(std::shared_ptr<World> world);
+
+		/// Start one thread per world.
+		/// \param tickLimit The amount of ticks after which each world stops on its own. Runs until stop if not set.
+		/// \return False if the runner is already running.
+		bool start(std::optional<uint64_t> tickLimit = std::nullopt);
+
+		/// Ask all worlds to stop after their current tick and wait for their threads.
+		void stop();
+
+		/// Wait until all worlds have reached their tick limit or the runner has been stopped.
+		void wait();
+
+		[[nodiscard]] bool isRunning() const { return running; }
+
+		/// Collect the tick statistics of all worlds.
+		/// \return The statistics in the order the worlds have been added.
+		[[nodiscard]] std::vector<TickStatistics> getStatistics() const;
+
+	private:
+		std::chrono::nanoseconds tickInterval;
+		std::vector<std::shared_ptr<World>> worlds;
+		std::vector<TickStatistics> statistics;
+		mutable std::mutex statisticsMutex;
+		std::vector<std::thread> threads;
+		std::atomic<bool> running;
+		std::atomic<bool> stopRequested;
+
+		void runWorld(size_t worldIndex, std::optional<uint64_t> tickLimit);
+};
+
+#endif //JAREP_SIMULATIONRUNNER_HPP
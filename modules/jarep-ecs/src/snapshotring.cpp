@@ -0,0 +1,49 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#include "snapshotring.hpp"
+
+#include <algorithm>
+
+SnapshotRing::SnapshotRing(size_t capacity) {
+	snapshots = std::vector<WorldSnapshot>(std::max<size_t>(capacity, 1));
+	frames = std::vector<std::optional<uint64_t>>(snapshots.size());
+}
+
+void SnapshotRing::capture(World &world, uint64_t frame) {
+	auto slot = findSlot(frame);
+	if (!slot.has_value()) {
+		slot = nextSlot;
+		nextSlot = (nextSlot + 1) % snapshots.size();
+	}
+	world.captureSnapshot(snapshots[slot.value()]);
+	frames[slot.value()] = frame;
+}
+
+bool SnapshotRing::restore(World &world, uint64_t frame) const {
+	auto slot = findSlot(frame);
+	if (!slot.has_value()) return false;
+	return world.restoreSnapshot(snapshots[slot.value()]);
+}
+
+bool SnapshotRing::contains(uint64_t frame) const {
+	return findSlot(frame).has_value();
+}
+
+std::optional<uint64_t> SnapshotRing::getOldestFrame() const {
+	std::optional<uint64_t> oldestFrame;
+	for (const auto &slotFrame: frames) {
+		if (slotFrame.has_value() && (!oldestFrame.has_value() || slotFrame.value() < oldestFrame.value())) {
+			oldestFrame = slotFrame;
+		}
+	}
+	return oldestFrame;
+}
+
+std::optional<size_t> SnapshotRing::findSlot(uint64_t frame) const {
+	for (size_t slot = 0; slot < frames.size(); ++slot) {
+		if (frames[slot] == frame) return std::make_optional(slot);
+	}
+	return std::nullopt;
+}
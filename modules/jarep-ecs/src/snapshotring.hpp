@@ -0,0 +1,52 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_SNAPSHOTRING_HPP
+#define JAREP_SNAPSHOTRING_HPP
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "world.hpp"
+#include "worldsnapshot.hpp"
+
+/// Keeps the snapshots of the latest frames of a world, e.g. to rewind the simulation for rollback networking. Once the
+/// ring is full, every capture overwrites the oldest frame and reuses its memory.
+class SnapshotRing {
+
+	public:
+		/// Create a ring without any frames.
+		/// \param capacity The amount of frames the ring keeps. At least one.
+		explicit SnapshotRing(size_t capacity);
+
+		/// Capture a world as a frame. A frame that is already in the ring, e.g. because it is simulated again after a
+		/// rollback, is overwritten, otherwise the oldest frame is replaced.
+		/// \param world The world to capture.
+		/// \param frame The number of the frame.
+		void capture(World &world, uint64_t frame);
+
+		/// Restore a world to a frame. The frames after it stay in the ring until they are captured again.
+		/// \param world The world to restore.
+		/// \param frame The number of the frame.
+		/// \return False if the frame is not in the ring.
+		bool restore(World &world, uint64_t frame) const;
+
+		/// Check if a frame is in the ring.
+		[[nodiscard]] bool contains(uint64_t frame) const;
+
+		/// Get the oldest frame in the ring.
+		/// \return The frame or nullopt if nothing has been captured yet.
+		[[nodiscard]] std::optional<uint64_t> getOldestFrame() const;
+
+		[[nodiscard]] size_t getCapacity() const { return snapshots.size(); }
+
+	private:
+		std::vector<WorldSnapshot> snapshots;
+		std::vector<std::optional<uint64_t>> frames;
+		size_t nextSlot = 0;
+
+		[[nodiscard]] std::optional<size_t> findSlot(uint64_t frame) const;
+};
+
+#endif //JAREP_SNAPSHOTRING_HPP
@@ -0,0 +1,129 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_SOACOLUMN_HPP
+#define JAREP_SOACOLUMN_HPP
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <variant>
+#include <vector>
+#include "component.hpp"
+#include "rowbitmask.hpp"
+
+/// The amount of rows the field arrays are aligned and padded to. Eight floats fill one AVX register.
+const size_t SOA_BATCH_WIDTH = 8;
+
+/// Components made of float fields can be gathered into separate arrays per field. They opt in by listing the fields,
+/// e.g. `static constexpr auto soaFields() { return std::array{&Position::x, &Position::y, &Position::z}; }`
+template<class T>
+concept SoAComponent = std::is_base_of_v<Component, T> && requires {
+	{ T::soaFields().size() } -> std::convertible_to<size_t>;
+	requires std::is_same_v<typename decltype(T::soaFields())::value_type, float T::*>;
+};
+
+/// Allocator that aligns every allocation to a fixed boundary.
+template<class T, size_t Alignment>
+struct AlignedAllocator {
+	typedef T value_type;
+
+	template<class U>
+	struct rebind {
+		typedef AlignedAllocator<U, Alignment> other;
+	};
+
+	AlignedAllocator() = default;
+
+	template<class U>
+	explicit AlignedAllocator(const AlignedAllocator<U, Alignment> &) {}
+
+	T *allocate(size_t count) {
+		return static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+	}
+
+	void deallocate(T *pointer, size_t) {
+		::operator delete(pointer, std::align_val_t(Alignment));
+	}
+
+	bool operator==(const AlignedAllocator &) const { return true; }
+};
+
+/// A gather/scatter helper holding a copy of the fields of all rows of a component column, split into one array per field.
+/// The component instances stay the primary storage, so gathering and scattering each cost one pass over all rows per
+/// field and the copy is only worth it if the work done on the arrays outweighs them. The arrays start on a batch
+/// boundary and are padded to a whole number of batches.
+template<SoAComponent T>
+class SoAColumn {
+
+	public:
+		static constexpr size_t fieldCount = T::soaFields().size();
+
+		/// Copy the fields of all rows into the field arrays. Vacant and skipped rows are filled with zeros.
+		/// \param components The rows of the column.
+		/// \param skippedRows The rows that are not copied, e.g. disabled ones.
+		void gather(const std::vector<std::shared_ptr<T>> &components, const RowBitmask &skippedRows) {
+			rowCount = components.size();
+			size_t paddedRowCount = getBatchCount() * SOA_BATCH_WIDTH;
+			for (size_t field = 0; field < fieldCount; ++field) {
+				auto &fieldArray = fieldArrays[field];
+				fieldArray.assign(paddedRowCount, 0.0f);
+				const auto member = T::soaFields()[field];
+				for (size_t row = 0; row < rowCount; ++row) {
+					if (components[row] && !skippedRows.test(row)) fieldArray[row] = (*components[row]).*member;
+				}
+			}
+		}
+
+		/// Copy the field arrays back into the rows. Vacant and skipped rows and the padding are left untouched.
+		/// \param components The rows of the column. Must be the rows the arrays have been gathered from.
+		/// \param skippedRows The rows that are not written, e.g. disabled ones.
+		void scatter(std::vector<std::shared_ptr<T>> &components, const RowBitmask &skippedRows) const {
+			for (size_t field = 0; field < fieldCount; ++field) {
+				const auto &fieldArray = fieldArrays[field];
+				const auto member = T::soaFields()[field];
+				for (size_t row = 0; row < rowCount && row < components.size(); ++row) {
+					if (components[row] && !skippedRows.test(row)) (*components[row]).*member = fieldArray[row];
+				}
+			}
+		}
+
+		/// Get the array of a field, holding getBatchCount() * SOA_BATCH_WIDTH values.
+		/// \param fieldIndex The index of the field in soaFields.
+		float *getField(size_t fieldIndex) { return fieldArrays[fieldIndex].data(); }
+
+		/// Get the array of a field for reading, holding getBatchCount() * SOA_BATCH_WIDTH values.
+		/// \param fieldIndex The index of the field in soaFields.
+		[[nodiscard]] const float *getField(size_t fieldIndex) const { return fieldArrays[fieldIndex].data(); }
+
+		/// Fetch the amount of rows, excluding the padding.
+		[[nodiscard]] size_t getRowCount() const { return rowCount; }
+
+		/// Fetch the amount of batches needed to cover all rows.
+		[[nodiscard]] size_t getBatchCount() const { return (rowCount + SOA_BATCH_WIDTH - 1) / SOA_BATCH_WIDTH; }
+
+	private:
+		std::array<std::vector<float, AlignedAllocator<float, SOA_BATCH_WIDTH * sizeof(float)>>, fieldCount> fieldArrays;
+		size_t rowCount = 0;
+};
+
+/// Resolves to the SoA column of a component type, or to an empty placeholder if the type is not a SoA component.
+template<class T>
+struct SoAColumnStorage {
+	typedef std::monostate type;
+};
+
+template<SoAComponent T>
+struct SoAColumnStorage<T> {
+	typedef SoAColumn<T> type;
+};
+
+/// The column a chunk callback receives for a component type. Types requested as const are passed as read-only columns.
+template<class T>
+using SoAColumnParameter = std::conditional_t<std::is_const_v<T>, const SoAColumn<std::remove_const_t<T>> &,
+		SoAColumn<T> &>;
+
+#endif //JAREP_SOACOLUMN_HPP
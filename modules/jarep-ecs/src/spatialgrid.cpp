@@ -0,0 +1,166 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#include "spatialgrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/// Spread the lowest 21 bits of a value, so two zero bits follow every bit.
+static uint64_t spreadMortonBits(uint64_t value) {
+	value &= 0x1fffff;
+	value = (value | value << 32) & 0x1f00000000ffff;
+	value = (value | value << 16) & 0x1f0000ff0000ff;
+	value = (value | value << 8) & 0x100f00f00f00f00f;
+	value = (value | value << 4) & 0x10c30c30c30c30c3;
+	value = (value | value << 2) & 0x1249249249249249;
+	return value;
+}
+
+uint64_t computeMortonCode(SpatialPoint position, float cellSize) {
+	if (cellSize <= 0.0f) cellSize = 1.0f;
+
+	// The cells are shifted by half the range, so negative coordinates get codes as well.
+	auto toCell = [cellSize](float coordinate) {
+		double cell = std::floor(coordinate / cellSize) + static_cast<double>(1 << 20);
+		// NaN passes the clamp unchanged, so it is put into the cell of the origin.
+		if (std::isnan(cell)) cell = static_cast<double>(1 << 20);
+		return static_cast<uint64_t>(std::clamp(cell, 0.0, static_cast<double>((1 << 21) - 1)));
+	};
+	return spreadMortonBits(toCell(position.x)) | spreadMortonBits(toCell(position.y)) << 1 |
+	       spreadMortonBits(toCell(position.z)) << 2;
+}
+
+SpatialGrid::SpatialGrid(float cellSize) {
+	this->cellSize = cellSize > 0.0f ? cellSize : 1.0f;
+}
+
+void SpatialGrid::update(Entity entity, SpatialPoint position) {
+	if (!std::isfinite(position.x) || !std::isfinite(position.y) || !std::isfinite(position.z)) {
+		remove(entity);
+		return;
+	}
+	CellKey newCell = getCellKey(position).value();
+
+	auto entityCellResult = entityCells.find(entity);
+	if (entityCellResult == entityCells.end()) {
+		entityCells.emplace(entity, EntityCell{position, newCell});
+		cells[newCell].push_back(entity);
+		return;
+	}
+
+	auto &entityCell = entityCellResult->second;
+	entityCell.position = position;
+	if (entityCell.cell == newCell) return;
+
+	removeFromCell(entity, entityCell.cell);
+	entityCell.cell = newCell;
+	cells[newCell].push_back(entity);
+}
+
+void SpatialGrid::remove(Entity entity) {
+	auto entityCellResult = entityCells.find(entity);
+	if (entityCellResult == entityCells.end()) return;
+
+	removeFromCell(entity, entityCellResult->second.cell);
+	entityCells.erase(entityCellResult);
+}
+
+void SpatialGrid::clear() {
+	cells.clear();
+	entityCells.clear();
+}
+
+std::vector<Entity> SpatialGrid::queryAABB(SpatialPoint min, SpatialPoint max) const {
+	auto foundEntities = std::vector<Entity>();
+	auto isInside = [&min, &max](const SpatialPoint &position) {
+		return position.x >= min.x && position.x <= max.x && position.y >= min.y && position.y <= max.y &&
+		       position.z >= min.z && position.z <= max.z;
+	};
+	auto collectCell = [this, &foundEntities, &isInside](const std::vector<Entity> &cellEntities) {
+		for (const Entity entity: cellEntities) {
+			if (isInside(entityCells.at(entity).position)) foundEntities.push_back(entity);
+		}
+	};
+
+	auto minCellResult = getCellKey(min);
+	auto maxCellResult = getCellKey(max);
+	if (!minCellResult.has_value() || !maxCellResult.has_value()) return foundEntities;
+	CellKey minCell = minCellResult.value();
+	CellKey maxCell = maxCellResult.value();
+	if (minCell.x > maxCell.x || minCell.y > maxCell.y || minCell.z > maxCell.z) return foundEntities;
+
+	// Boxes that span more cells than are occupied are cheaper to answer by visiting the occupied cells directly.
+	double queriedCellCount = (static_cast<double>(maxCell.x) - minCell.x + 1) *
+	                          (static_cast<double>(maxCell.y) - minCell.y + 1) *
+	                          (static_cast<double>(maxCell.z) - minCell.z + 1);
+	if (queriedCellCount > static_cast<double>(cells.size())) {
+		for (const auto &cell: cells) {
+			collectCell(cell.second);
+		}
+		return foundEntities;
+	}
+
+	// The counters are wider than the cell coordinates, so they cannot overflow at the edge of the grid.
+	for (int64_t x = minCell.x; x <= maxCell.x; ++x) {
+		for (int64_t y = minCell.y; y <= maxCell.y; ++y) {
+			for (int64_t z = minCell.z; z <= maxCell.z; ++z) {
+				auto cellResult = cells.find(
+						CellKey{static_cast<int32_t>(x), static_cast<int32_t>(y), static_cast<int32_t>(z)});
+				if (cellResult != cells.end()) collectCell(cellResult->second);
+			}
+		}
+	}
+	return foundEntities;
+}
+
+std::vector<Entity> SpatialGrid::queryRadius(SpatialPoint center, float radius) const {
+	auto min = SpatialPoint{center.x - radius, center.y - radius, center.z - radius};
+	auto max = SpatialPoint{center.x + radius, center.y + radius, center.z + radius};
+	auto foundEntities = queryAABB(min, max);
+
+	// The box around the sphere also contains its corners, which are removed by the exact distance check.
+	float squaredRadius = radius * radius;
+	std::erase_if(foundEntities, [this, &center, squaredRadius](Entity entity) {
+		const auto &position = entityCells.at(entity).position;
+		float dx = position.x - center.x;
+		float dy = position.y - center.y;
+		float dz = position.z - center.z;
+		return dx * dx + dy * dy + dz * dz > squaredRadius;
+	});
+	return foundEntities;
+}
+
+std::optional<SpatialPoint> SpatialGrid::getPosition(Entity entity) const {
+	auto entityCellResult = entityCells.find(entity);
+	if (entityCellResult == entityCells.end()) return std::nullopt;
+	return std::make_optional(entityCellResult->second.position);
+}
+
+std::optional<SpatialGrid::CellKey> SpatialGrid::getCellKey(SpatialPoint position) const {
+	if (std::isnan(position.x) || std::isnan(position.y) || std::isnan(position.z)) return std::nullopt;
+
+	// Converting a value outside the range of int32_t is undefined, so far away positions share the outermost cells.
+	auto toCell = [this](float coordinate) {
+		double cell = std::floor(static_cast<double>(coordinate) / cellSize);
+		return static_cast<int32_t>(std::clamp(cell, static_cast<double>(std::numeric_limits<int32_t>::min()),
+		                                       static_cast<double>(std::numeric_limits<int32_t>::max())));
+	};
+	return std::make_optional(CellKey{toCell(position.x), toCell(position.y), toCell(position.z)});
+}
+
+void SpatialGrid::removeFromCell(Entity entity, const CellKey &cell) {
+	auto cellResult = cells.find(cell);
+	if (cellResult == cells.end()) return;
+
+	// The order inside a cell does not matter, so the entity is swapped with the last one.
+	auto &cellEntities = cellResult->second;
+	auto entityResult = std::find(cellEntities.begin(), cellEntities.end(), entity);
+	if (entityResult != cellEntities.end()) {
+		*entityResult = cellEntities.back();
+		cellEntities.pop_back();
+	}
+	if (cellEntities.empty()) cells.erase(cellResult);
+}
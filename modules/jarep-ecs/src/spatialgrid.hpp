@@ -0,0 +1,110 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_SPATIALGRID_HPP
+#define JAREP_SPATIALGRID_HPP
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include "entity.hpp"
+
+/// A position in world space, as stored by the spatial grid.
+struct SpatialPoint {
+	float x = 0.0f;
+	float y = 0.0f;
+	float z = 0.0f;
+};
+
+/// Interleave the bits of the cell coordinates of a position into a Morton code. Positions close to each other in space
+/// mostly get close codes, so sorting by the code keeps neighbouring entities next to each other in memory. Every axis
+/// is covered by 21 bits of cells around the origin, coordinates outside that range are clamped.
+/// \param position The position to encode.
+/// \param cellSize The edge length of the cells the positions are quantized to.
+/// \return The Morton code of the cell containing the position.
+uint64_t computeMortonCode(SpatialPoint position, float cellSize);
+
+/// Uniform grid that sorts entities into cubic cells by their position. Only occupied cells are stored, so the grid is
+/// unbounded. Proximity queries only visit the cells that overlap the queried volume instead of every entity.
+class SpatialGrid {
+
+	public:
+		/// Create an empty grid.
+		/// \param cellSize The edge length of a cell. Queries are fastest if it is close to the usual query radius.
+		explicit SpatialGrid(float cellSize);
+
+		~SpatialGrid() = default;
+
+		/// Insert an entity or move it to a new position. The entity only changes its cell if it has left the old one.
+		/// Positions with an infinite or NaN coordinate cannot be sorted into a cell, the entity is removed instead.
+		/// \param entity The entity to insert or move.
+		/// \param position The current position of the entity.
+		void update(Entity entity, SpatialPoint position);
+
+		/// Remove an entity from the grid.
+		/// \param entity The entity to remove.
+		void remove(Entity entity);
+
+		/// Remove all entities from the grid.
+		void clear();
+
+		/// Collect all entities whose position is inside an axis aligned box, including the boundary. Infinite corners are
+		/// allowed, a box with a NaN coordinate contains nothing.
+		/// \param min The corner of the box with the smallest coordinates.
+		/// \param max The corner of the box with the largest coordinates.
+		/// \return The entities inside the box in no particular order.
+		[[nodiscard]] std::vector<Entity> queryAABB(SpatialPoint min, SpatialPoint max) const;
+
+		/// Collect all entities whose position is within a distance of a center point.
+		/// \param center The center of the sphere.
+		/// \param radius The radius of the sphere.
+		/// \return The entities inside the sphere in no particular order.
+		[[nodiscard]] std::vector<Entity> queryRadius(SpatialPoint center, float radius) const;
+
+		/// Get the last position an entity has been inserted with.
+		/// \return The position or nullopt if the entity is not part of the grid.
+		[[nodiscard]] std::optional<SpatialPoint> getPosition(Entity entity) const;
+
+		/// Fetch the amount of entities in the grid.
+		[[nodiscard]] size_t size() const { return entityCells.size(); }
+
+		/// Fetch the amount of occupied cells.
+		[[nodiscard]] size_t getCellCount() const { return cells.size(); }
+
+	private:
+		struct CellKey {
+			int32_t x;
+			int32_t y;
+			int32_t z;
+
+			bool operator==(const CellKey &other) const = default;
+		};
+
+		struct CellKeyHash {
+			size_t operator()(const CellKey &key) const {
+				// Mix the coordinates with large primes, so neighbouring cells do not end up in neighbouring buckets.
+				return static_cast<size_t>(key.x) * 73856093u ^ static_cast<size_t>(key.y) * 19349663u ^
+				       static_cast<size_t>(key.z) * 83492791u;
+			}
+		};
+
+		struct EntityCell {
+			SpatialPoint position;
+			CellKey cell;
+		};
+
+		float cellSize;
+		std::unordered_map<CellKey, std::vector<Entity>, CellKeyHash> cells;
+		std::unordered_map<Entity, EntityCell> entityCells;
+
+		/// Get the cell containing a position. Coordinates beyond the range of the cell coordinates are clamped to the
+		/// outermost cells.
+		/// \return The cell or nullopt if a coordinate is NaN.
+		[[nodiscard]] std::optional<CellKey> getCellKey(SpatialPoint position) const;
+
+		void removeFromCell(Entity entity, const CellKey &cell);
+};
+
+#endif //JAREP_SPATIALGRID_HPP
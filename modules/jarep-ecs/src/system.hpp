@@ -12,8 +12,10 @@
 #include <unordered_map>
 #include <functional>
 #include <tuple>
+#include <chrono>
 #include "systemmanager.hpp"
 #include "componentmanager.hpp"
+#include "eventbus.hpp"
 
 class System {
 
@@ -28,6 +30,12 @@ class System {
 
 		virtual void update() = 0;
 
+		/// Get the time the current update covers. For systems in a fixed step group this is the fixed time step,
+		/// otherwise it is the time since the last tick. Updates skipped by a run condition add their time as well.
+		[[nodiscard]] std::chrono::nanoseconds getDeltaTime() const {
+			return deltaTime;
+		}
+
 		template<typename T>
 		std::optional<std::shared_ptr<T>> getComponent(Entity entity) {
 			auto componentRef = entityComponentReferenceMap.at(entity);
@@ -43,6 +51,22 @@ class System {
 			return component ? std::make_optional(component) : std::nullopt;
 		}
 
+		/// Send an event to all systems. It can be read after the current tick has finished.
+		/// \tparam T The event type.
+		/// \param event The event to send.
+		template<typename T>
+		void sendEvent(const T &event) {
+			eventBus->getChannel<T>().send(event);
+		}
+
+		/// Read all events of a type that have been sent during the previous tick.
+		/// \tparam T The event type.
+		/// \return The events, valid until the current tick has finished.
+		template<typename T>
+		std::span<const T> readEvents() {
+			return eventBus->getChannel<T>().read();
+		}
+
 		std::vector<Entity> getEntities() const {
 			std::vector<Entity> entities;
 			for (const auto &pair: entityComponentReferenceMap) {
@@ -55,6 +79,8 @@ class System {
 	private:
 		std::unordered_map<Entity, std::tuple<Signature, size_t>> entityComponentReferenceMap;
 		std::shared_ptr<GetComponentsFunc> getComponentFunc;
+		std::chrono::nanoseconds deltaTime = std::chrono::nanoseconds(0);
+		std::shared_ptr<EventBus> eventBus;
 
 		friend class SystemManager;
 		friend class WorldFriendAccessor;
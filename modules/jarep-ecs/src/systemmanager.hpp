@@ -9,34 +9,102 @@
 #include <vector>
 #include <optional>
 #include <typeindex>
+#include <chrono>
+#include <algorithm>
+#include <functional>
 #include "signature.hpp"
 #include "componentmanager.hpp"
 #include "system.hpp"
+#include "worldstats.hpp"
+#include "systemprofiler.hpp"
+
+typedef size_t SystemGroupId;
+
+/// The group every system belongs to unless another group is requested. It is updated once per tick.
+const SystemGroupId DEFAULT_SYSTEM_GROUP = 0;
+
+/// A group of systems that share an update rate. Groups without a fixed time step are updated once per tick. Groups with
+/// a fixed time step accumulate the tick time and are updated once for every full time step.
+struct SystemGroup {
+	/// The time step of the group or zero if the group is updated once per tick.
+	std::chrono::nanoseconds fixedTimeStep = std::chrono::nanoseconds(0);
+	/// The maximum amount of catch-up steps per tick. Time beyond that is dropped, so a slow frame can not cause an
+	/// ever-growing backlog.
+	size_t maxStepsPerTick = 1;
+	/// The tick time that has not been consumed by a time step yet.
+	std::chrono::nanoseconds accumulatedTime = std::chrono::nanoseconds(0);
+	/// The systems of this group in the order they are updated.
+	std::vector<std::type_index> systems;
+};
+
+/// Conditions the system manager checks before it updates a system. A system whose conditions are not met is skipped
+/// without being called, so idle systems do not cost an update. The time of skipped updates is added to the delta time
+/// of the next update that runs, so the system always sees the time since its last update.
+struct SystemRunCondition {
+	/// Skip the system while no entity matches its required components.
+	bool requireEntities = false;
+	/// Update the system only on every N-th update of its group. Zero and one update it every time.
+	uint64_t interval = 1;
+	/// Skip the system while this function returns the same value as before the last update of the system, e.g. the
+	/// version of a resource the system reads. The system always runs if no function is set.
+	std::function<uint64_t()> changeVersion;
+};
 
 /// The system manager is responsible for dealing with all issues regarding the updating and maintaining of the system deriving classes.
 class SystemManager {
 
 	public:
-		SystemManager() = default;
+		SystemManager() {
+			systemGroups.emplace_back();
+		}
+
 		~SystemManager() = default;
 
+		/// Create a new group of systems. Groups are updated in the order of their creation, after the default group.
+		/// \param fixedTimeStep The time step of the group or zero if the group shall be updated once per tick.
+		/// \param maxStepsPerTick The maximum amount of time steps the group may catch up within a single tick.
+		/// \return The id of the new group.
+		SystemGroupId createSystemGroup(std::chrono::nanoseconds fixedTimeStep, size_t maxStepsPerTick) {
+			SystemGroup group;
+			group.fixedTimeStep = fixedTimeStep;
+			group.maxStepsPerTick = std::max<size_t>(maxStepsPerTick, 1);
+			systemGroups.push_back(std::move(group));
+			return systemGroups.size() - 1;
+		}
+
+		/// Get the progress of a fixed step group towards its next time step, which is used to interpolate between the
+		/// last two states it has produced.
+		/// \param groupId The group to check.
+		/// \return A value between 0 and 1 or nullopt if the group does not exist or has no fixed time step.
+		std::optional<double> getInterpolationAlpha(SystemGroupId groupId) const {
+			if (groupId >= systemGroups.size()) return std::nullopt;
+			const auto &group = systemGroups[groupId];
+			if (group.fixedTimeStep.count() == 0) return std::nullopt;
+			return std::make_optional(static_cast<double>(group.accumulatedTime.count()) /
+			                          static_cast<double>(group.fixedTimeStep.count()));
+		}
+
 		/// Register a system for the update process
 		/// \tparam T The type of the system that shall be registered. Must derive vom System
 		/// \param systemSignature The Signature of the system, composed by the component signatures needed by this system.
 		/// \param getComponentsFunc Functor to the component manager to access component data fast and easy.
 		/// \return Optional type index of the system for further usage.
+		/// \param groupId The group that decides how often the system gets updated.
 		template<class T, class = typename std::enable_if<std::is_base_of<System, T>::value>::type>
-		std::optional<std::type_index> registerSystem(Signature systemSignature, std::shared_ptr<GetComponentsFunc> getComponentsFunc) {
+		std::optional<std::type_index> registerSystem(Signature systemSignature, std::shared_ptr<GetComponentsFunc> getComponentsFunc,
+		                                              SystemGroupId groupId = DEFAULT_SYSTEM_GROUP) {
 
 			// If the system is already registered, another registration is illegal.
-			if (isSystemRegistred(typeid(T))) return std::nullopt;
+			if (isSystemRegistred(typeid(T)) || groupId >= systemGroups.size()) return std::nullopt;
 
 			// Create the system instance and prepare it.
 			std::unique_ptr<System> system = std::make_unique<T>();
 			system->getComponentFunc = std::move(getComponentsFunc);
+			system->eventBus = eventBus;
 
 			systemTypeIndexMap.insert_or_assign(typeid(T), std::move(system));
 			systemSignatureMap.insert_or_assign(typeid(T), systemSignature);
+			systemGroups[groupId].systems.emplace_back(typeid(T));
 			return std::make_optional(std::type_index(typeid(T)));
 		}
 
@@ -51,6 +119,11 @@ class SystemManager {
 
 			systemTypeIndexMap.erase(typeid(T));
 			systemSignatureMap.erase(typeid(T));
+			lastUpdateDurationMap.erase(typeid(T));
+			runStates.erase(typeid(T));
+			for (auto &group: systemGroups) {
+				std::erase(group.systems, std::type_index(typeid(T)));
+			}
 
 			for(const auto entity: entities){
 				for(auto systemType: assignedEntitySystemMap[entity]){
@@ -65,11 +138,66 @@ class SystemManager {
 
 		}
 
-		/// RecreateSurface all systems registered in this manager.
+		/// RecreateSurface all systems registered in this manager once, regardless of the update rate of their group.
 		void update() {
 			for (auto &system: systemTypeIndexMap) {
-				system.second->update();
+				updateSystem(system.first, *system.second, std::chrono::nanoseconds(0));
 			}
+			frameCount++;
+		}
+
+		/// Advance all system groups by the time of a tick. Groups without a fixed time step are updated once with the tick
+		/// time. Fixed step groups are updated once for every full time step that has accumulated.
+		/// \param deltaTime The time that has passed since the last tick.
+		void update(std::chrono::nanoseconds deltaTime) {
+			for (auto &group: systemGroups) {
+				if (group.fixedTimeStep.count() == 0) {
+					updateGroup(group, deltaTime);
+					continue;
+				}
+
+				group.accumulatedTime += deltaTime;
+				size_t steps = 0;
+				while (group.accumulatedTime >= group.fixedTimeStep && steps < group.maxStepsPerTick) {
+					updateGroup(group, group.fixedTimeStep);
+					group.accumulatedTime -= group.fixedTimeStep;
+					steps++;
+				}
+				// Drop the time the group could not catch up with, but keep the progress towards the next step.
+				if (group.accumulatedTime >= group.fixedTimeStep) {
+					group.accumulatedTime %= group.fixedTimeStep;
+				}
+			}
+			eventBus->publish();
+			frameCount++;
+		}
+
+		/// Set the conditions under which a system is updated. They replace any conditions set before.
+		/// \param systemType The type of the system.
+		/// \param runCondition The conditions that have to be met for an update of the system.
+		/// \return False if the system is not registered.
+		bool setRunCondition(std::type_index systemType, SystemRunCondition runCondition) {
+			if (!isSystemRegistred(systemType)) return false;
+			SystemRunState runState;
+			runState.condition = std::move(runCondition);
+			runStates.insert_or_assign(systemType, std::move(runState));
+			return true;
+		}
+
+		/// Get the event bus all systems of this manager communicate through.
+		std::shared_ptr<EventBus> getEventBus() {
+			return eventBus;
+		}
+
+		/// Count a structural change of the world, like creating an entity or adding a component. The changes that happen
+		/// during the update of a system are attributed to that system by the profiler.
+		void recordStructuralChange() {
+			structuralChangeCount++;
+		}
+
+		/// Get the profiler that records the update calls of all systems.
+		SystemProfiler &getProfiler() {
+			return profiler;
 		}
 
 		/// RecreateSurface a system with new associated entities, signatures and their respected indices in the archetypes.
@@ -101,6 +229,35 @@ class SystemManager {
 
 
 
+		/// Refresh the signature and archetype index a system uses to access the components of an entity.
+		/// \param entity The entity whose components have been moved.
+		/// \param signature The signature of the archetype the components are stored in.
+		/// \param archetypeIndex The new index of the entity in the archetype.
+		void updateEntityReference(Entity entity, Signature signature, size_t archetypeIndex) {
+			if (!assignedEntitySystemMap.contains(entity)) return;
+
+			for (auto &systemType: assignedEntitySystemMap[entity]) {
+				if (!systemTypeIndexMap.contains(systemType)) continue;
+				auto &referenceMap = systemTypeIndexMap[systemType]->entityComponentReferenceMap;
+				if (!referenceMap.contains(entity)) continue;
+				referenceMap[entity] = std::make_tuple(signature, archetypeIndex);
+			}
+		}
+
+		/// Unlink all entities from all systems.
+		void clearEntities() {
+			for (auto &system: systemTypeIndexMap) {
+				system.second->entityComponentReferenceMap.clear();
+			}
+			assignedEntitySystemMap.clear();
+		}
+
+		/// Collect the required signature of every registered system.
+		/// \return Pairs of the system type and its signature.
+		std::vector<std::pair<std::type_index, Signature>> getSystemSignatures() const {
+			return {systemSignatureMap.begin(), systemSignatureMap.end()};
+		}
+
 		/// Remove an entity from all systems that are associated with this one.
 		/// \param entity The entity to remove from all systems.
 		void removeEntityFromSystems(Entity& entity){
@@ -127,6 +284,34 @@ class SystemManager {
 			return systemIds;
 		}
 
+		/// Collect all systems whose required components are part of a signature.
+		/// \param entitySignature The signature of an entity.
+		/// \return The type indices of all systems that shall process entities with this signature.
+		std::vector<std::type_index> getSystemsMatchingSignature(Signature entitySignature){
+			auto systemIds = std::vector<std::type_index>();
+			for(const auto& systemSignature: systemSignatureMap){
+				if((entitySignature & systemSignature.second) != systemSignature.second) continue;
+				systemIds.push_back(systemSignature.first);
+			}
+			return systemIds;
+		}
+
+		/// Collect the entity count and the duration of the latest update of every registered system.
+		/// \return The statistics of all systems.
+		std::vector<SystemStats> getSystemStats() {
+			auto systemStats = std::vector<SystemStats>();
+			for (const auto &system: systemTypeIndexMap) {
+				SystemStats stats;
+				stats.systemType = system.first.name();
+				stats.linkedEntityCount = system.second->entityComponentReferenceMap.size();
+				if (lastUpdateDurationMap.contains(system.first)) {
+					stats.lastUpdateDuration = lastUpdateDurationMap[system.first];
+				}
+				systemStats.push_back(stats);
+			}
+			return systemStats;
+		}
+
 //		void setSystemExecutionOrder();
 
 	private:
@@ -134,9 +319,84 @@ class SystemManager {
 		std::unordered_map<std::type_index, Signature> systemSignatureMap;
 
 		std::unordered_map<Entity, std::vector<std::type_index>> assignedEntitySystemMap;
+		std::unordered_map<std::type_index, std::chrono::nanoseconds> lastUpdateDurationMap;
+
+		/// The run condition of a system and what has been seen of it during the previous updates.
+		struct SystemRunState {
+			SystemRunCondition condition;
+			uint64_t updateRequestCount = 0;
+			std::optional<uint64_t> lastVersion;
+			/// The delta time of the updates that have been skipped since the last update of the system.
+			std::chrono::nanoseconds skippedTime = std::chrono::nanoseconds(0);
+		};
+		std::unordered_map<std::type_index, SystemRunState> runStates;
+
+		std::vector<SystemGroup> systemGroups;
+		std::shared_ptr<EventBus> eventBus = std::make_shared<EventBus>();
+
+		SystemProfiler profiler;
+		size_t structuralChangeCount = 0;
+		uint64_t frameCount = 0;
 //		std::vector<System> lateUpdateSystems;
 //		std::vector<System> renderSystems;
 
+		void updateGroup(SystemGroup &group, std::chrono::nanoseconds deltaTime) {
+			for (const auto &systemType: group.systems) {
+				updateSystem(systemType, *systemTypeIndexMap[systemType], deltaTime);
+			}
+		}
+
+		/// Check the run condition of a system before its update.
+		/// \param deltaTime The time of this update. If the system runs, the time of the updates it has skipped is added.
+		/// \return True if the system shall be updated.
+		bool shouldRun(std::type_index systemType, const System &system, std::chrono::nanoseconds &deltaTime) {
+			auto runStateResult = runStates.find(systemType);
+			if (runStateResult == runStates.end()) return true;
+			auto &runState = runStateResult->second;
+			if (!isRunConditionMet(runState, system)) {
+				runState.skippedTime += deltaTime;
+				return false;
+			}
+			deltaTime += runState.skippedTime;
+			runState.skippedTime = std::chrono::nanoseconds(0);
+			return true;
+		}
+
+		bool isRunConditionMet(SystemRunState &runState, const System &system) {
+			const auto &condition = runState.condition;
+
+			// The cheap checks come first, so the version is only requested and consumed when the system would run.
+			uint64_t updateRequest = runState.updateRequestCount++;
+			if (condition.interval > 1 && updateRequest % condition.interval != 0) return false;
+			if (condition.requireEntities && system.entityComponentReferenceMap.empty()) return false;
+			if (condition.changeVersion) {
+				uint64_t version = condition.changeVersion();
+				if (runState.lastVersion == version) return false;
+				runState.lastVersion = version;
+			}
+			return true;
+		}
+
+		void updateSystem(std::type_index systemType, System &system, std::chrono::nanoseconds deltaTime) {
+			if (!shouldRun(systemType, system, deltaTime)) return;
+			size_t structuralChangesBefore = structuralChangeCount;
+			system.deltaTime = deltaTime;
+			auto startTime = std::chrono::steady_clock::now();
+			system.update();
+			auto duration = std::chrono::steady_clock::now() - startTime;
+			lastUpdateDurationMap[systemType] = duration;
+
+			if (!profiler.isEnabled()) return;
+			SystemProfileSample sample;
+			sample.systemName = systemType.name();
+			sample.frame = frameCount;
+			sample.startTime = startTime;
+			sample.duration = duration;
+			sample.linkedEntityCount = system.entityComponentReferenceMap.size();
+			sample.structuralChanges = structuralChangeCount - structuralChangesBefore;
+			profiler.record(sample);
+		}
+
 		bool isSystemRegistred(std::type_index systemTypeID){
 			return systemTypeIndexMap.contains(systemTypeID);
 		}
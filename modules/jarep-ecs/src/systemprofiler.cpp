@@ -0,0 +1,65 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#include "systemprofiler.hpp"
+
+SystemProfiler::SystemProfiler(size_t capacity) {
+	samples = std::vector<SystemProfileSample>(capacity);
+	nextSample = 0;
+	sampleCount = 0;
+	isRecording = false;
+	creationTime = std::chrono::steady_clock::now();
+}
+
+void SystemProfiler::record(const SystemProfileSample &sample) {
+	if (!isRecording || samples.empty()) return;
+
+	samples[nextSample] = sample;
+	nextSample = (nextSample + 1) % samples.size();
+	if (sampleCount < samples.size()) sampleCount++;
+}
+
+void SystemProfiler::reset(size_t capacity) {
+	samples = std::vector<SystemProfileSample>(capacity);
+	nextSample = 0;
+	sampleCount = 0;
+}
+
+std::vector<SystemProfileSample> SystemProfiler::getSamples() const {
+	auto orderedSamples = std::vector<SystemProfileSample>();
+	orderedSamples.reserve(sampleCount);
+
+	// If the buffer has wrapped around, the oldest sample is the one that will be overwritten next.
+	size_t firstSample = sampleCount < samples.size() ? 0 : nextSample;
+	for (size_t i = 0; i < sampleCount; ++i) {
+		orderedSamples.push_back(samples[(firstSample + i) % samples.size()]);
+	}
+	return orderedSamples;
+}
+
+void SystemProfiler::exportChromeTrace(std::ostream &stream) const {
+	stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	bool isFirstEvent = true;
+	for (const auto &sample: getSamples()) {
+		auto startMicroseconds = std::chrono::duration<double, std::micro>(sample.startTime - creationTime).count();
+		auto durationMicroseconds = std::chrono::duration<double, std::micro>(sample.duration).count();
+
+		if (!isFirstEvent) stream << ",";
+		isFirstEvent = false;
+
+		stream << "{\"name\":\"";
+		for (const char *character = sample.systemName; character != nullptr && *character != '\0'; ++character) {
+			if (*character == '"' || *character == '\\') stream << '\\';
+			stream << *character;
+		}
+		stream << "\",\"cat\":\"system\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+		       << ",\"ts\":" << startMicroseconds
+		       << ",\"dur\":" << durationMicroseconds
+		       << ",\"args\":{\"frame\":" << sample.frame
+		       << ",\"linkedEntities\":" << sample.linkedEntityCount
+		       << ",\"structuralChanges\":" << sample.structuralChanges << "}}";
+	}
+	stream << "]}";
+}
@@ -0,0 +1,70 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_SYSTEMPROFILER_HPP
+#define JAREP_SYSTEMPROFILER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/// A single measured update call of a system.
+struct SystemProfileSample {
+	/// The type name of the system. Points to static storage of the type info, so copying samples never allocates.
+	const char *systemName = nullptr;
+	/// The index of the tick the update belongs to.
+	uint64_t frame = 0;
+	std::chrono::steady_clock::time_point startTime;
+	std::chrono::nanoseconds duration = std::chrono::nanoseconds(0);
+	/// The amount of entities linked to the system during the update. This is the amount the system could have visited,
+	/// not the amount its update actually iterated.
+	size_t linkedEntityCount = 0;
+	/// The amount of entities and components that have been created or destroyed during the update.
+	size_t structuralChanges = 0;
+};
+
+/// Collects the update samples of all systems in a fixed size ring buffer. Once the buffer is full, the oldest samples
+/// are overwritten, so recording never allocates. The samples can be exported in the Chrome trace event format, which
+/// can be opened in Perfetto or chrome://tracing.
+class SystemProfiler {
+
+	public:
+		/// Create a disabled profiler.
+		/// \param capacity The amount of samples the ring buffer can hold.
+		explicit SystemProfiler(size_t capacity = 4096);
+
+		~SystemProfiler() = default;
+
+		/// Enable or disable recording. Disabled profilers ignore all samples.
+		void setEnabled(bool enabled) { isRecording = enabled; }
+
+		[[nodiscard]] bool isEnabled() const { return isRecording; }
+
+		/// Store a sample and overwrite the oldest one if the buffer is full.
+		/// \param sample The sample to store.
+		void record(const SystemProfileSample &sample);
+
+		/// Remove all samples and resize the ring buffer.
+		/// \param capacity The amount of samples the ring buffer can hold from now on.
+		void reset(size_t capacity);
+
+		/// Collect all stored samples.
+		/// \return The samples, ordered from oldest to newest.
+		[[nodiscard]] std::vector<SystemProfileSample> getSamples() const;
+
+		/// Write all stored samples as Chrome trace events. Every sample becomes a complete event, whose arguments contain
+		/// the frame, the linked entity count and the structural changes of the update.
+		/// \param stream The stream to write the JSON document to.
+		void exportChromeTrace(std::ostream &stream) const;
+
+	private:
+		std::vector<SystemProfileSample> samples;
+		size_t nextSample;
+		size_t sampleCount;
+		bool isRecording;
+		std::chrono::steady_clock::time_point creationTime;
+};
+
+#endif //JAREP_SYSTEMPROFILER_HPP
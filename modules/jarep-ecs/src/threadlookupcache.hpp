@@ -0,0 +1,49 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_THREADLOOKUPCACHE_HPP
+#define JAREP_THREADLOOKUPCACHE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// The id no owner of a cached object may use, as it marks an empty cache entry.
+const uint64_t THREAD_LOOKUP_CACHE_EMPTY_ID = 0;
+
+/// A small cache of the objects a thread has looked up last, meant to be held thread_local. The keys are ids that are
+/// never reused, so an entry of a destroyed owner can never be hit again. Entries are replaced round robin, so a thread
+/// that outlives many owners keeps at most Capacity stale entries instead of one per owner ever used.
+/// \tparam T The type of the cached objects.
+/// \tparam Capacity The amount of entries.
+template<class T, size_t Capacity = 4>
+class ThreadLookupCache {
+
+	public:
+		/// Find the object cached for an id.
+		/// \param id The id of the owner.
+		/// \return The object or nullptr if it is not cached.
+		T *find(uint64_t id) const {
+			for (size_t i = 0; i < Capacity; ++i) {
+				if (ids[i] == id) return values[i];
+			}
+			return nullptr;
+		}
+
+		/// Cache an object and replace the oldest entry if the cache is full.
+		/// \param id The id of the owner. Must not be THREAD_LOOKUP_CACHE_EMPTY_ID.
+		/// \param value The object to cache.
+		void insert(uint64_t id, T *value) {
+			ids[nextEntry] = id;
+			values[nextEntry] = value;
+			nextEntry = (nextEntry + 1) % Capacity;
+		}
+
+	private:
+		std::array<uint64_t, Capacity> ids{};
+		std::array<T *, Capacity> values{};
+		size_t nextEntry = 0;
+};
+
+#endif //JAREP_THREADLOOKUPCACHE_HPP
@@ -10,18 +10,44 @@
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
+#include <bit>
+#include <chrono>
+#include <string>
+#include <istream>
+#include <ostream>
+#include <functional>
+#include <numeric>
+#include <span>
+#include <sstream>
 #include "entitymanager.hpp"
 #include "componentmanager.hpp"
 #include "systemmanager.hpp"
+#include "serialization.hpp"
+#include "mappedlevel.hpp"
+#include "worldstats.hpp"
+#include "spatialgrid.hpp"
+#include "sharedcomponentstore.hpp"
+#include "dynamicbuffer.hpp"
+#include "worldsnapshot.hpp"
+#include "worlddiff.hpp"
+
+/// Callback that reacts to a component type being added to or removed from entities. Observers are called once per
+/// batch of entities that share an archetype, e.g. once for all entities created by a single instantiate call.
+typedef std::function<void(std::span<const Entity>)> ComponentObserver;
 
 /// The world class is the top instance of the the JAREP-ECS. It manages the entity-, component- and system manager instances and
 /// provides the necessary interfaces to interact with components and systems from outside the ecs.
 class World {
 	public:
 
-		World() {
+		World() : World(std::make_shared<ComponentRegistry>()) {}
+
+		/// Create a world whose component signatures are assigned by a registry that can be shared with other worlds.
+		/// \param componentRegistry The registry assigning the signature bits of all component types.
+		explicit World(std::shared_ptr<ComponentRegistry> componentRegistry) {
 			entityManager = std::make_unique<EntityManager>();
-			componentManager = std::make_unique<ComponentManager>();
+			componentManager = std::make_unique<ComponentManager>(std::move(componentRegistry));
 			systemManager = std::make_unique<SystemManager>();
 		}
 
@@ -36,10 +62,141 @@ class World {
 			auto newEntity = newEntityResult.value();
 			const int archetypeIndex = 0;
 			entityManager->assignNewSignature(newEntity, Signature(0), archetypeIndex);
+			systemManager->recordStructuralChange();
 			return std::make_optional(newEntity);
 		}
 
-		/// Remove an entity. All component instances will be destroyed in the process.
+		/// Reserve an entity from any thread, e.g. from a worker job that generates content. No lock is shared with the
+		/// world, the entity becomes part of the world when the reservations are committed at the start of the next tick.
+		/// \return The reserved entity or nullopt if the maximum amount of entities has been reached.
+		std::optional<Entity> reserveEntity() {
+			return entityManager->reserveEntity();
+		}
+
+		/// Add all reserved entities to the world as entities without components. This is the sync point of
+		/// reserveEntity and must not run while other threads reserve entities. It is called at the start of every tick.
+		/// \return The committed entities.
+		std::vector<Entity> commitReservedEntities() {
+			auto reservedEntities = entityManager->collectReservedEntities();
+			for (const Entity entity: reservedEntities) {
+				const int archetypeIndex = 0;
+				entityManager->assignNewSignature(entity, Signature(0), archetypeIndex);
+				systemManager->recordStructuralChange();
+			}
+			return reservedEntities;
+		}
+
+		/// Get the registry that assigns the signature bits of this world.
+		std::shared_ptr<ComponentRegistry> getComponentRegistry() const {
+			return componentManager->getComponentRegistry();
+		}
+
+		/// Move entities with all their components from one world to another. The component columns of every archetype
+		/// are transferred at once and the component instances are handed over instead of being copied. The entities are
+		/// removed from the source world, which leaves their rows vacant until the next defragmentation, and are created
+		/// anew in the target world, where the add observers and systems are notified once per archetype.
+		/// \param source The world the entities are taken from.
+		/// \param target The world the entities are moved to.
+		/// \param entities The entities to move. All must be alive in the source world.
+		/// \return The entities in the target world, in the order of the moved entities. Nullopt if the worlds are the same,
+		/// an entity is invalid, a component type cannot be registered in the target world or the target world cannot
+		/// create enough entities, in which case nothing is moved. Component types may have been registered in the target
+		/// world anyway.
+		static std::optional<std::vector<Entity>> moveEntities(World &source, World &target, std::span<const Entity> entities) {
+			if (&source == &target) return std::nullopt;
+
+			// Group the entities by their archetype, so every column is transferred once. Every group holds the row and the
+			// position in the entity span of its entities.
+			auto archetypeRows = std::unordered_map<Signature, std::vector<std::pair<size_t, size_t>>>();
+			auto archetypeSignatures = std::vector<Signature>();
+			auto uniqueEntities = std::unordered_set<Entity>();
+			for (size_t position = 0; position < entities.size(); ++position) {
+				auto signature = source.entityManager->getSignature(entities[position]);
+				auto archetypeIndex = source.entityManager->getArchetypeIndex(entities[position]);
+				if (!signature.has_value() || !archetypeIndex.has_value()) return std::nullopt;
+				if (!uniqueEntities.insert(entities[position]).second) return std::nullopt;
+
+				if (!archetypeRows.contains(signature.value())) archetypeSignatures.push_back(signature.value());
+				archetypeRows[signature.value()].emplace_back(archetypeIndex.value(), position);
+			}
+
+			// Everything that can make the target world refuse the rows is checked before the source world is touched.
+			if (target.entityManager->getCreatableEntityCount() < entities.size()) return std::nullopt;
+			for (const auto &signature: archetypeSignatures) {
+				if (signature == Signature(0)) continue;
+				for (const auto &componentType: source.componentManager->getArchetype(signature).value()->getComponentTypes()) {
+					target.componentManager->registerComponent(componentType);
+					if (!target.componentManager->isComponentRegistred(componentType)) return std::nullopt;
+				}
+			}
+
+			auto movedEntities = std::vector<Entity>(entities.size());
+			for (const auto &signature: archetypeSignatures) {
+				// Rows are taken in archetype order, so neighbouring rows form ranges that are migrated at once.
+				auto &rows = archetypeRows.at(signature);
+				std::sort(rows.begin(), rows.end());
+				auto groupEntities = std::vector<Entity>();
+				auto rowRanges = std::vector<std::pair<size_t, size_t>>();
+				groupEntities.reserve(rows.size());
+				for (const auto &[row, position]: rows) {
+					groupEntities.push_back(entities[position]);
+					if (!rowRanges.empty() && rowRanges.back().first + rowRanges.back().second == row) {
+						rowRanges.back().second++;
+					} else {
+						rowRanges.emplace_back(row, 1);
+					}
+				}
+
+				auto componentTypes = std::vector<std::type_index>();
+				auto collections = std::vector<std::unique_ptr<ComponentInstanceCollection>>();
+				if (signature != Signature(0)) {
+					auto archetype = source.componentManager->getArchetype(signature).value();
+					componentTypes = archetype->getComponentTypes();
+					for (const auto &componentType: componentTypes) {
+						source.notifyObservers(source.removeObservers, componentType, groupEntities);
+					}
+
+					for (const auto &componentType: componentTypes) {
+						auto sourceCollection = archetype->getCollection(componentType).value();
+						auto collection = sourceCollection->createNewAndEmpty();
+						for (const auto &[firstRow, rowCount]: rowRanges) {
+							sourceCollection->migrateRange(firstRow, rowCount, *collection);
+						}
+						collections.push_back(std::move(collection));
+					}
+				}
+
+				for (Entity entity: groupEntities) {
+					source.systemManager->removeEntityFromSystems(entity);
+					source.entityManager->releaseEntity(entity);
+					source.systemManager->recordStructuralChange();
+				}
+
+				auto createdEntities = std::vector<Entity>();
+				createdEntities.reserve(groupEntities.size());
+				if (!target.insertArchetypeRows(componentTypes, std::move(collections), groupEntities.size(),
+				                                createdEntities)) {
+					return std::nullopt;
+				}
+				for (size_t i = 0; i < rows.size(); ++i) {
+					movedEntities[rows[i].second] = createdEntities[i];
+				}
+			}
+
+			// Shared values move along with their entities and join the group of an equal value in the target world.
+			for (const auto &sharedComponentStore: source.sharedComponentStores) {
+				auto &targetStore = target.sharedComponentStores[sharedComponentStore.first];
+				if (!targetStore) targetStore = sharedComponentStore.second->createNewAndEmpty();
+				for (size_t position = 0; position < entities.size(); ++position) {
+					sharedComponentStore.second->moveEntity(entities[position], *targetStore, movedEntities[position]);
+				}
+			}
+			return std::make_optional(movedEntities);
+		}
+
+		/// Remove an entity. All component instances will be destroyed in the process. The row of the entity is left
+		/// vacant until the next defragmentation, so removing an entity costs the same regardless of the archetype size
+		/// and the rows of all other entities stay where they are.
 		/// \param entity The entity to destroy.
 		void removeEntity(Entity entity) {
 
@@ -50,10 +207,22 @@ class World {
 				return;
 			}
 
-			componentManager->removeEntityComponents(entitySignature.value(), entityArchetypeIndex.value());
+			// Observers are notified while the components can still be read.
+			if (entitySignature.value() != Signature(0)) {
+				auto archetype = componentManager->getArchetype(entitySignature.value()).value();
+				for (const auto &componentType: archetype->getComponentTypes()) {
+					notifyObservers(removeObservers, componentType, std::span<const Entity>(&entity, 1));
+				}
+			}
+
+			componentManager->vacateEntityComponents(entitySignature.value(), entityArchetypeIndex.value());
 			systemManager->removeEntityFromSystems(entity);
+			for (const auto &sharedComponentStore: sharedComponentStores) {
+				sharedComponentStore.second->remove(entity);
+			}
 
-			entityManager->removeEntity(entity);
+			entityManager->releaseEntity(entity);
+			systemManager->recordStructuralChange();
 
 		}
 
@@ -81,7 +250,7 @@ class World {
 			// identifiers, each component instance is linked to a single entity by.
 			auto newEntityData = componentManager->addComponentToSignature(oldSignature.value(),
 			                                                               oldArchetypeIndex.value(),
-			                                                               std::make_shared<T>());
+			                                                               createComponentInstance<T>());
 			// Check if the component was assigned correctly.
 			if (!newEntityData.has_value()) return;
 
@@ -90,6 +259,7 @@ class World {
 			auto newSignature = newEntityData.value().first;
 			auto newArchetypeIndex = newEntityData.value().second;
 			entityManager->assignNewSignature(entity, newSignature, newArchetypeIndex);
+			systemManager->recordStructuralChange();
 
 			// Collect all system which require the component type in their signature. The entity gets linked to these systems.
 			auto newEntityAccessors = std::unordered_map<Entity, std::tuple<Signature, size_t>>();
@@ -97,6 +267,8 @@ class World {
 			for (const auto &systemId: systemManager->getSystemsContainingSignature(oldSignature.value())) {
 				systemManager->addEntitiesToSystem(systemId, newEntityAccessors);
 			}
+
+			notifyObservers(addObservers, typeid(T), std::span<const Entity>(&entity, 1));
 		}
 
 		/// Remove an component from an entity. The instance of the component will be destroyed. Also the entity will be dereferenced from
@@ -113,30 +285,270 @@ class World {
 				return;
 			}
 
+			// Observers are notified while the component can still be read.
+			auto componentSignature = componentManager->getCombinedSignatureOfTypes({typeid(T)});
+			if (!componentSignature.has_value() || (oldSignature.value() & componentSignature.value()).none()) return;
+			notifyObservers(removeObservers, typeid(T), std::span<const Entity>(&entity, 1));
+
 			auto newEntityData = componentManager->removeComponentFromSignature<T>(oldSignature.value(), oldArchetypeIndex.value());
 			if (!newEntityData.has_value()) return;
 
 			Signature newSignature = newEntityData.value().first;
 			size_t newArchetypeIndex = newEntityData.value().second;
 			entityManager->assignNewSignature(entity, newSignature, newArchetypeIndex);
+			systemManager->recordStructuralChange();
 
 			systemManager->removeEntityFromSystem(entity, oldSignature.value());
 		}
 
+		/// Get the instance of a component attached to an entity.
+		/// \tparam T The type of component to get. Must derive from Component.
+		/// \param entity The entity the component belongs to.
+		/// \return The component instance or nullopt if the entity does not exist or has no component of this type.
+		template<class T, class = typename std::enable_if<std::is_base_of<Component, T>::value>::type>
+		std::optional<std::shared_ptr<T>> getComponent(Entity entity) {
+			auto signature = entityManager->getSignature(entity);
+			auto archetypeIndex = entityManager->getArchetypeIndex(entity);
+			if (!signature.has_value() || !archetypeIndex.has_value()) return std::nullopt;
+			auto componentSignature = componentManager->getCombinedSignatureOfTypes({typeid(T)});
+			if (!componentSignature.has_value() || (signature.value() & componentSignature.value()).none()) {
+				return std::nullopt;
+			}
+			return componentManager->getComponent<T>(signature.value(), archetypeIndex.value());
+		}
+
+		/// Assign a shared component value to an entity. Each distinct value is stored once and the entities are grouped by
+		/// their value. Shared components are not part of the entity signature and are not visible to systems.
+		/// \tparam T The shared component type. Must derive from Component and be equality comparable.
+		/// \param entity The entity to assign the value to.
+		/// \param value The value to assign. Replaces the previous value of the entity.
+		/// \return False if the entity does not exist.
+		template<SharedComponent T>
+		bool setSharedComponent(Entity entity, const T &value) {
+			if (!entityManager->getSignature(entity).has_value()) return false;
+			getSharedComponentStore<T>().set(entity, value);
+			return true;
+		}
+
+		/// Get the shared component value of an entity.
+		/// \tparam T The shared component type.
+		/// \param entity The entity whose value is requested.
+		/// \return The value shared by all entities of its group or nullopt if the entity has no value of this type.
+		template<SharedComponent T>
+		std::optional<std::shared_ptr<const T>> getSharedComponent(Entity entity) {
+			return getSharedComponentStore<T>().get(entity);
+		}
+
+		/// Remove the shared component value of an entity.
+		/// \tparam T The shared component type.
+		/// \param entity The entity whose value is removed.
+		template<SharedComponent T>
+		void removeSharedComponent(Entity entity) {
+			getSharedComponentStore<T>().remove(entity);
+		}
+
+		/// Call a function once per distinct value of a shared component with all entities that share it, e.g. to draw
+		/// all entities with the same material at once.
+		/// \tparam T The shared component type.
+		/// \param callback Callable receiving the value as const T & and the entities as std::span<const Entity>.
+		template<SharedComponent T, class Callback>
+		void forEachSharedComponentGroup(Callback &&callback) {
+			getSharedComponentStore<T>().forEachGroup(std::forward<Callback>(callback));
+		}
+
+		/// Enable or disable a component of an entity. The component stays in place, toggling only flips a bit of its row
+		/// and is not a structural change. Disabled components are skipped by forEachEnabled and are not returned to systems.
+		/// \tparam T The component type. Must derive from Component.
+		/// \param entity The entity the component belongs to.
+		/// \param enabled The new state of the component.
+		/// \return False if the entity does not exist or has no component of this type.
+		template<class T, class = typename std::enable_if<std::is_base_of<Component, T>::value>::type>
+		bool setComponentEnabled(Entity entity, bool enabled) {
+			auto signature = entityManager->getSignature(entity);
+			auto archetypeIndex = entityManager->getArchetypeIndex(entity);
+			if (!signature.has_value() || !archetypeIndex.has_value()) return false;
+			return componentManager->setComponentEnabled(signature.value(), archetypeIndex.value(), typeid(T), enabled);
+		}
+
+		/// Check if a component of an entity is enabled.
+		/// \tparam T The component type. Must derive from Component.
+		/// \param entity The entity the component belongs to.
+		/// \return The state of the component or nullopt if the entity does not exist or has no component of this type.
+		template<class T, class = typename std::enable_if<std::is_base_of<Component, T>::value>::type>
+		std::optional<bool> isComponentEnabled(Entity entity) {
+			auto signature = entityManager->getSignature(entity);
+			auto archetypeIndex = entityManager->getArchetypeIndex(entity);
+			if (!signature.has_value() || !archetypeIndex.has_value()) return std::nullopt;
+			return componentManager->isComponentEnabled(signature.value(), archetypeIndex.value(), typeid(T));
+		}
+
+		/// Call a function for every row that holds all requested component types with all of them enabled. The rows are
+		/// found by combining the disabled masks of the columns, so whole words of disabled rows are skipped at once.
+		/// All visited rows are marked as changed. The callback must not add or remove entities or components.
+		/// \tparam T The component types.
+		/// \param callback Callable receiving a T & per component type.
+		template<class... T, class Callback>
+		void forEachEnabled(Callback &&callback) {
+			visitEnabledRows<true, T...>(callback);
+		}
+
+		/// Call a function for every row that holds all requested component types with all of them enabled, without
+		/// marking the rows as changed, e.g. to extract the render data of a frame. The callback must not add or remove
+		/// entities or components.
+		/// \tparam T The component types.
+		/// \param callback Callable receiving a const T & per component type.
+		template<class... T, class Callback>
+		void readEachEnabled(Callback &&callback) {
+			visitEnabledRows<false, T...>([&callback](const T &... components) { callback(components...); });
+		}
+
+		/// Register an observer that is called after a component type has been added to entities. Entities created by
+		/// instantiate or load are reported in one call per archetype instead of one call per entity.
+		/// \tparam T The observed component type. Must derive from Component.
+		/// \param observer The callback receiving the entities the component has been added to.
+		template<class T, class = typename std::enable_if<std::is_base_of<Component, T>::value>::type>
+		void onAdd(ComponentObserver observer) {
+			addObservers[typeid(T)].push_back(std::move(observer));
+		}
+
+		/// Register an observer that is called before a component type is removed from entities, either by
+		/// removeComponent or by removing the entity itself. The components can still be read during the call.
+		/// \tparam T The observed component type. Must derive from Component.
+		/// \param observer The callback receiving the entities the component is removed from.
+		template<class T, class = typename std::enable_if<std::is_base_of<Component, T>::value>::type>
+		void onRemove(ComponentObserver observer) {
+			removeObservers[typeid(T)].push_back(std::move(observer));
+		}
+
+		/// Create a spatial index over the positions stored in a component type. Entities enter and leave the index through
+		/// the add and remove observers of the component. Every tick the positions of the rows marked as changed are read
+		/// again, so entities nobody has written to since the changed rows have been cleared are not visited. Positions
+		/// written through instances that have been handed out before the last clearChangedRows() are not picked up.
+		/// \tparam T The component type holding the position. Must derive from Component.
+		/// \param cellSize The edge length of the grid cells.
+		/// \param getPosition Function that reads the position from a component instance.
+		/// \return False if the component type already has a spatial index.
+		template<class T, class = typename std::enable_if<std::is_base_of<Component, T>::value>::type>
+		bool createSpatialIndex(float cellSize, std::function<SpatialPoint(const T &)> getPosition) {
+			if (spatialIndices.contains(typeid(T))) return false;
+
+			auto spatialIndex = std::make_shared<SpatialGrid>(cellSize);
+			spatialIndices.emplace(typeid(T), spatialIndex);
+
+			auto indexEntities = [this, spatialIndex, getPosition](std::span<const Entity> entities) {
+				for (const Entity entity: entities) {
+					auto component = getComponent<T>(entity);
+					if (!component.has_value()) continue;
+					spatialIndex->update(entity, getPosition(*component.value()));
+				}
+			};
+			onAdd<T>(indexEntities);
+			onRemove<T>([spatialIndex](std::span<const Entity> entities) {
+				for (const Entity entity: entities) {
+					spatialIndex->remove(entity);
+				}
+			});
+			spatialIndexRefreshers.emplace_back([this, spatialIndex, getPosition]() {
+				const auto &rowEntities = getRowEntities();
+				for (const auto &signature: componentManager->getArchetypeSignatures()) {
+					auto archetype = componentManager->getArchetype(signature).value();
+					auto collection = archetype->getCollection(typeid(T));
+					if (!collection.has_value() || !rowEntities.contains(signature)) continue;
+
+					const auto &entities = rowEntities.at(signature);
+					const auto &componentList = std::any_cast<std::reference_wrapper<const std::vector<std::shared_ptr<T>>>>(
+							collection.value()->as_any_const()).get();
+					const auto &changedRows = collection.value()->getChangedRows();
+					for (size_t wordIndex = 0; wordIndex * RowBitmask::BITS_PER_WORD < componentList.size(); ++wordIndex) {
+						uint64_t changedWord = changedRows.getWord(wordIndex);
+						while (changedWord != 0) {
+							size_t row = wordIndex * RowBitmask::BITS_PER_WORD + std::countr_zero(changedWord);
+							changedWord &= changedWord - 1;
+							if (row >= componentList.size() || row >= entities.size() || !componentList[row]) continue;
+							spatialIndex->update(entities[row], getPosition(*componentList[row]));
+						}
+					}
+				}
+			});
+			auto rebuildIndex = [this, spatialIndex, indexEntities]() {
+				spatialIndex->clear();
+				indexEntities(entityManager->getAllActiveEntities());
+			};
+			spatialIndexRebuilders.emplace_back(rebuildIndex);
+
+			rebuildIndex();
+			return true;
+		}
+
+		/// Get the spatial index of a component type.
+		/// \tparam T The component type holding the position.
+		/// \return The index or nullopt if no index has been created for the component type.
+		template<class T, class = typename std::enable_if<std::is_base_of<Component, T>::value>::type>
+		std::optional<const SpatialGrid *> getSpatialIndex() const {
+			if (!spatialIndices.contains(typeid(T))) return std::nullopt;
+			return std::make_optional<const SpatialGrid *>(spatialIndices.at(typeid(T)).get());
+		}
+
+		/// Read the positions of the rows marked as changed and move the entities whose position has changed. Called at the
+		/// start of every tick and before the changed rows are cleared, call it manually to query positions written since.
+		void refreshSpatialIndices() {
+			for (const auto &refreshSpatialIndex: spatialIndexRefreshers) {
+				refreshSpatialIndex();
+			}
+		}
+
+		/// Run a callback over the fields of SoA components, once per archetype that contains all of them. This is a
+		/// gather/scatter helper: the fields of every column are copied into aligned float arrays before the callback and
+		/// written back after it, which costs one pass over all rows per field in each direction and only pays off if the
+		/// callback does enough work per row. Rows that are vacant or disabled in any of the columns read as zero and their
+		/// results are dropped. Types requested as const are only gathered: they are neither written back nor marked as
+		/// changed. The callback must not add or remove entities or components.
+		/// \tparam T The SoA component types, const for columns that are only read.
+		/// \param callback Callable receiving a SoAColumnParameter<T> per component type, i.e. a SoAColumn & or a
+		/// const SoAColumn &. All columns have the same row count.
+		template<class... T, class Callback>
+		requires (SoAComponent<std::remove_const_t<T>> && ...)
+		void forEachSoAChunk(Callback &&callback) {
+			auto requiredSignatureResult = componentManager->getCombinedSignatureOfTypes({typeid(T)...});
+			if (!requiredSignatureResult.has_value()) return;
+			Signature requiredSignature = requiredSignatureResult.value();
+
+			for (const auto &signature: componentManager->getArchetypeSignatures()) {
+				if ((signature & requiredSignature) != requiredSignature) continue;
+				auto archetype = componentManager->getArchetype(signature).value();
+				if (archetype->getEntityCount() == 0) continue;
+
+				auto collections = std::make_tuple(static_cast<InstanceCollection<std::remove_const_t<T>> *>(
+						archetype->getCollection(typeid(T)).value())...);
+				auto skippedRows = RowBitmask();
+				std::apply([&skippedRows](auto *... collection) {
+					(skippedRows.merge(collection->getDisabledRows()), ...);
+				}, collections);
+				callback(static_cast<SoAColumnParameter<T>>(
+						std::get<InstanceCollection<std::remove_const_t<T>> *>(collections)->gatherSoAColumn(skippedRows))...);
+				([&collections, &skippedRows]() {
+					if constexpr (!std::is_const_v<T>) {
+						std::get<InstanceCollection<T> *>(collections)->scatterSoAColumn(skippedRows);
+					}
+				}(), ...);
+			}
+		}
+
 		/// Register a system for updates during the update cycle. A new instance of the system will be created and existing components and entities that are
 		/// required will be linked in the process.
 		/// \tparam T The type of system to register. Must derive of System.
 		/// \param requiredComponents A collection of all component type indices that are required by the system.
+		/// \param groupId The system group that decides how often the system gets updated.
 		/// \return True if the registration was successful, false if an error occurred.
 		template<class T, class = typename std::enable_if<std::is_base_of<System, T>::value>::type>
-		bool registerSystem(std::vector<std::type_index> requiredComponents) {
+		bool registerSystem(std::vector<std::type_index> requiredComponents, SystemGroupId groupId = DEFAULT_SYSTEM_GROUP) {
 
 			auto systemSignatureResult = componentManager->getCombinedSignatureOfTypes(std::move(requiredComponents));
 			if (!systemSignatureResult.has_value()) throw std::exception();
 
 
 			auto getComponentsFunc = std::make_shared<GetComponentsFunc>(this->componentManager);
-			auto systemIndexResult = systemManager->registerSystem<T>(systemSignatureResult.value(), getComponentsFunc);
+			auto systemIndexResult = systemManager->registerSystem<T>(systemSignatureResult.value(), getComponentsFunc, groupId);
 
 			if (!systemIndexResult.has_value()) return false;
 
@@ -156,9 +568,683 @@ class World {
 
 		}
 
-		/// RecreateSurface all systems
+		/// Set the conditions under which a system is updated, e.g. only while entities match it or only every few ticks.
+		/// Systems whose conditions are not met are skipped before they are called.
+		/// \tparam T The type of the system. Must derive from System.
+		/// \param runCondition The conditions that have to be met for an update of the system.
+		/// \return False if the system is not registered.
+		template<class T, class = typename std::enable_if<std::is_base_of<System, T>::value>::type>
+		bool setRunCondition(SystemRunCondition runCondition) {
+			return systemManager->setRunCondition(typeid(T), std::move(runCondition));
+		}
+
+		/// Create a group of systems with its own update rate.
+		/// \param fixedTimeStep The time step the systems of the group are updated with. Zero updates the group once per tick.
+		/// \param maxStepsPerTick The maximum amount of time steps the group may catch up within a single tick.
+		/// \return The id of the group, which can be passed to registerSystem.
+		SystemGroupId createSystemGroup(std::chrono::nanoseconds fixedTimeStep, size_t maxStepsPerTick = 8) {
+			return systemManager->createSystemGroup(fixedTimeStep, maxStepsPerTick);
+		}
+
+		/// Get the progress of a fixed step group towards its next time step. Systems that run every tick can use it to
+		/// interpolate between the last two states the group has produced.
+		/// \param groupId The fixed step group.
+		/// \return A value between 0 and 1 or nullopt if the group does not exist or has no fixed time step.
+		std::optional<double> getInterpolationAlpha(SystemGroupId groupId) const {
+			return systemManager->getInterpolationAlpha(groupId);
+		}
+
+		/// RecreateSurface all system groups with the time that has passed since the last tick.
 		void tick() {
-			systemManager->update();
+			auto now = std::chrono::steady_clock::now();
+			auto deltaTime = lastTickTime.has_value() ? now - lastTickTime.value() : std::chrono::nanoseconds(0);
+			lastTickTime = now;
+			commitReservedEntities();
+			refreshSpatialIndices();
+			systemManager->update(std::chrono::duration_cast<std::chrono::nanoseconds>(deltaTime));
+		}
+
+		/// RecreateSurface all system groups with an explicit tick time, e.g. for simulations that do not run in real time.
+		/// \param deltaTime The time the tick covers.
+		void tick(std::chrono::nanoseconds deltaTime) {
+			lastTickTime = std::chrono::steady_clock::now();
+			commitReservedEntities();
+			refreshSpatialIndices();
+			systemManager->update(deltaTime);
+		}
+
+		/// Create a new prefab without any components. A prefab is a template for entities that can be instantiated many
+		/// times. Its component values are stored in a hidden archetype row, which is not visible to any system.
+		/// \return The handle of the new prefab.
+		Prefab createPrefab() {
+			prefabArchetypes.push_back(Archetype::createEmpty());
+			return Prefab(prefabArchetypes.size() - 1);
+		}
+
+		/// Set the value of a component in a prefab. The component is added to the prefab if it does not contain it yet.
+		/// \tparam T The type of component to set. Must derive from Component.
+		/// \param prefab The prefab to modify.
+		/// \param value The value all instances of the prefab are initialized with.
+		/// \return False if the prefab does not exist.
+		template<class T, class = typename std::enable_if<std::is_base_of<Component, T>::value>::type>
+		bool setPrefabComponent(Prefab prefab, const T &value) {
+			if (prefab >= prefabArchetypes.size()) return false;
+
+			if (!componentManager->isComponentRegistred(typeid(T))) {
+				componentManager->registerComponent<T>();
+			}
+
+			auto &prefabArchetype = prefabArchetypes[prefab];
+			if (prefabArchetype->containsType<T>()) {
+				*prefabArchetype->getComponent<T>(0).value() = value;
+				return true;
+			}
+
+			// Move the row to an archetype that also contains the new component, like an entity does when a component is added.
+			auto extendedArchetype = Archetype::createFromAdd<T>(prefabArchetype).value();
+			extendedArchetype->migrateEntity(prefabArchetype, 0);
+			extendedArchetype->setComponentInstance(createComponentInstance<T>(value));
+			prefabArchetype = std::move(extendedArchetype);
+			return true;
+		}
+
+		/// Create entities from a prefab. The prefab row is copied into the archetype of the prefab once per component
+		/// type for all new entities, so no entity goes through addComponent.
+		/// \param prefab The prefab to instantiate.
+		/// \param count The amount of entities to create.
+		/// \return The created entities or nullopt if the prefab does not exist or not enough entities can be created.
+		std::optional<std::vector<Entity>> instantiate(Prefab prefab, size_t count) {
+			if (prefab >= prefabArchetypes.size()) return std::nullopt;
+
+			auto &prefabArchetype = prefabArchetypes[prefab];
+			auto componentTypes = prefabArchetype->getComponentTypes();
+			auto collections = std::vector<std::unique_ptr<ComponentInstanceCollection>>();
+			for (const auto &componentType: componentTypes) {
+				auto prefabCollection = prefabArchetype->getCollection(componentType).value();
+				auto collection = prefabCollection->createNewAndEmpty();
+				prefabCollection->appendCopies(0, count, *collection);
+				collections.push_back(std::move(collection));
+			}
+
+			auto createdEntities = std::vector<Entity>();
+			createdEntities.reserve(count);
+			if (!insertArchetypeRows(componentTypes, std::move(collections), count, createdEntities)) return std::nullopt;
+			return std::make_optional(createdEntities);
+		}
+
+		/// Make room for a known amount of entities with exactly the given components before spawning them. The columns
+		/// of their archetype and the entity tables are grown once, instead of reallocating repeatedly while the entities
+		/// are added. The archetype is created if it does not exist yet. A defragmentation pass releases it again while
+		/// it is still empty.
+		/// \tparam Components The component types of the entities. All must derive from Component.
+		/// \param count The amount of entities to make room for besides the existing ones.
+		template<class... Components> requires (sizeof...(Components) > 0 && (std::is_base_of_v<Component, Components> && ...))
+		void reserve(size_t count) {
+			(registerComponentIfMissing<Components>(), ...);
+			auto signature = componentManager->getCombinedSignatureOfTypes({typeid(Components)...}).value();
+			if (!componentManager->getArchetype(signature).has_value()) {
+				auto typedCollections = std::vector<std::pair<std::type_index, std::unique_ptr<ComponentInstanceCollection>>>();
+				(typedCollections.emplace_back(typeid(Components), std::make_unique<InstanceCollection<Components>>()), ...);
+				componentManager->insertArchetype(signature, Archetype::createFromCollections(std::move(typedCollections)));
+			}
+			componentManager->getArchetype(signature).value()->reserveRows(count);
+			entityManager->reserve(count);
+		}
+
+		/// Register the codec of a plain component, so its instances can be saved and loaded as raw bytes.
+		/// \tparam T The type of component. Must be a plain component.
+		/// \param name The name the component type is stored with. Must be the same for every build that reads the data.
+		template<PlainComponent T>
+		void registerComponentCodec(std::string name) {
+			addComponentCodec(typeid(T), addEntityFunctions<T>(createPlainCodec<T>(std::move(name))));
+		}
+
+		/// Register the codec of a component, so its instances can be saved and loaded.
+		/// \tparam T The type of component. Must derive from Component.
+		/// \param name The name the component type is stored with. Must be the same for every build that reads the data.
+		/// \param write Function that writes a single component instance to a stream.
+		/// \param read Function that reads a single component instance from a stream into a default constructed instance.
+		template<class T, class = typename std::enable_if<std::is_base_of<Component, T>::value>::type>
+		void registerComponentCodec(std::string name, std::function<void(const T &, std::ostream &)> write,
+		                            std::function<void(std::istream &, T &)> read) {
+			addComponentCodec(typeid(T), addEntityFunctions<T>(createCustomCodec<T>(std::move(name), std::move(write), std::move(read))));
+		}
+
+		/// Save all entities and their components to a binary stream. The archetypes are written column by column, so every
+		/// component type of an archetype is handled by a single codec call.
+		/// \param stream The stream to write to.
+		/// \return True if the world has been saved, false if a component type has no codec or the stream failed.
+		bool save(std::ostream &stream) {
+			auto savedSignatures = collectSavedSignatures(false);
+			if (!savedSignatures.has_value()) return false;
+
+			writeBinary(stream, WORLD_SNAPSHOT_MAGIC);
+			writeBinary(stream, WORLD_SNAPSHOT_VERSION);
+			writeBinary(stream, static_cast<uint32_t>(savedSignatures.value().size()));
+			for (const auto &signature: savedSignatures.value()) {
+				auto archetype = componentManager->getArchetype(signature).value();
+				auto componentTypes = archetype->getComponentTypes();
+				auto rows = getOccupiedRows(signature);
+
+				writeComponentNames(stream, componentTypes);
+				writeBinary(stream, static_cast<uint64_t>(rows.size()));
+				for (const auto &componentType: componentTypes) {
+					auto collection = archetype->getCollection(componentType).value();
+					componentCodecs.at(componentType).writeColumn(*collection, rows, stream);
+				}
+			}
+			return stream.good();
+		}
+
+		/// Save all entities and their components as a level file, which can be mapped into memory by MappedLevel. Every
+		/// column starts on its own page, so it can be used in place once the file is mapped. Level files can only contain
+		/// plain components.
+		/// \param stream The stream to write to.
+		/// \return True if the level has been saved, false if a component type has no plain codec or the stream failed.
+		bool saveLevel(std::ostream &stream) {
+			auto savedSignatures = collectSavedSignatures(true);
+			if (!savedSignatures.has_value()) return false;
+
+			// The offsets of all columns are part of the table of contents, so its size has to be known up front.
+			uint64_t tableOfContentsSize = 3 * sizeof(uint32_t);
+			for (const auto &signature: savedSignatures.value()) {
+				auto componentTypes = componentManager->getArchetype(signature).value()->getComponentTypes();
+				tableOfContentsSize += sizeof(uint32_t) + sizeof(uint64_t);
+				for (const auto &componentType: componentTypes) {
+					tableOfContentsSize += sizeof(uint32_t) + componentCodecs.at(componentType).name.size() + 2 * sizeof(uint64_t);
+				}
+			}
+
+			writeBinary(stream, LEVEL_FILE_MAGIC);
+			writeBinary(stream, LEVEL_FILE_VERSION);
+			writeBinary(stream, static_cast<uint32_t>(savedSignatures.value().size()));
+			uint64_t columnOffset = alignLevelOffset(tableOfContentsSize);
+			for (const auto &signature: savedSignatures.value()) {
+				auto componentTypes = componentManager->getArchetype(signature).value()->getComponentTypes();
+				uint64_t rowCount = getOccupiedRows(signature).size();
+
+				writeComponentNames(stream, componentTypes);
+				writeBinary(stream, rowCount);
+				for (const auto &componentType: componentTypes) {
+					uint64_t columnSize = rowCount * componentCodecs.at(componentType).packedSize;
+					writeBinary(stream, columnOffset);
+					writeBinary(stream, columnSize);
+					columnOffset = alignLevelOffset(columnOffset + columnSize);
+				}
+			}
+
+			uint64_t writtenBytes = tableOfContentsSize;
+			auto padding = std::vector<char>(LEVEL_COLUMN_ALIGNMENT, 0);
+			for (const auto &signature: savedSignatures.value()) {
+				auto archetype = componentManager->getArchetype(signature).value();
+				auto rows = getOccupiedRows(signature);
+				for (const auto &componentType: archetype->getComponentTypes()) {
+					stream.write(padding.data(), static_cast<std::streamsize>(alignLevelOffset(writtenBytes) - writtenBytes));
+					writtenBytes = alignLevelOffset(writtenBytes);
+
+					auto &codec = componentCodecs.at(componentType);
+					auto buffer = std::vector<std::byte>(rows.size() * codec.packedSize);
+					codec.packColumn(*archetype->getCollection(componentType).value(), rows, buffer.data());
+					stream.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+					writtenBytes += buffer.size();
+				}
+			}
+			return stream.good();
+		}
+
+		/// Create entities for all entities stored in a mapped level file. The components are unpacked directly from the
+		/// mapped columns into the archetypes, without reading the file into a buffer first.
+		/// \param level The mapped level file.
+		/// \return The created entities or nullopt if a component type of the level has no plain codec.
+		std::optional<std::vector<Entity>> load(const MappedLevel &level) {
+			for (const auto &archetype: level.getArchetypes()) {
+				for (const auto &componentName: archetype.componentNames) {
+					if (!componentCodecNames.contains(componentName)) return std::nullopt;
+					const auto &codec = componentCodecs.at(componentCodecNames.at(componentName));
+					if (codec.packedSize == 0) return std::nullopt;
+				}
+				for (size_t i = 0; i < archetype.columns.size(); ++i) {
+					const auto &codec = componentCodecs.at(componentCodecNames.at(archetype.componentNames[i]));
+					// The row count is read from the file, so the size is checked without a multiplication that could wrap.
+					if (archetype.columns[i].size() / codec.packedSize != archetype.rowCount ||
+					    archetype.columns[i].size() % codec.packedSize != 0) {
+						return std::nullopt;
+					}
+				}
+			}
+
+			auto loadedEntities = std::vector<Entity>();
+			for (const auto &archetype: level.getArchetypes()) {
+				auto componentTypes = std::vector<std::type_index>();
+				auto collections = std::vector<std::unique_ptr<ComponentInstanceCollection>>();
+				for (size_t i = 0; i < archetype.componentNames.size(); ++i) {
+					auto componentType = componentCodecNames.at(archetype.componentNames[i]);
+					const auto &codec = componentCodecs.at(componentType);
+					codec.registerComponent(*componentManager);
+					auto collection = codec.createCollection();
+					codec.unpackColumn(*collection, archetype.rowCount, archetype.columns[i].data());
+					componentTypes.push_back(componentType);
+					collections.push_back(std::move(collection));
+				}
+				if (!insertArchetypeRows(componentTypes, std::move(collections), archetype.rowCount, loadedEntities)) {
+					return std::nullopt;
+				}
+			}
+			return std::make_optional(loadedEntities);
+		}
+
+		/// Load entities and their components from a binary stream written by save(). New entities are created for all
+		/// stored entities. Their components are read column by column directly into the archetypes and all systems are
+		/// linked to the new entities once per archetype. If the data cannot be read, the world stays unchanged.
+		/// \param stream The stream to read from.
+		/// \return The created entities or nullopt if the data is invalid or a component type has no codec.
+		std::optional<std::vector<Entity>> load(std::istream &stream) {
+			uint32_t magic = 0;
+			uint32_t version = 0;
+			uint32_t archetypeCount = 0;
+			if (!readBinary(stream, magic) || !readBinary(stream, version) || !readBinary(stream, archetypeCount)) {
+				return std::nullopt;
+			}
+			if (magic != WORLD_SNAPSHOT_MAGIC || version != WORLD_SNAPSHOT_VERSION) return std::nullopt;
+
+			// Read everything into detached collections first, so broken data does not leave a half loaded world behind.
+			struct LoadedArchetype {
+				std::vector<std::type_index> componentTypes;
+				std::vector<std::unique_ptr<ComponentInstanceCollection>> collections;
+				size_t rowCount = 0;
+			};
+			// The counts are read from the stream and may be corrupt, so nothing is allocated for them up front.
+			auto loadedArchetypes = std::vector<LoadedArchetype>();
+			for (uint32_t archetypeIndex = 0; archetypeIndex < archetypeCount; ++archetypeIndex) {
+				auto &loadedArchetype = loadedArchetypes.emplace_back();
+				uint32_t componentCount = 0;
+				if (!readBinary(stream, componentCount)) return std::nullopt;
+				for (uint32_t i = 0; i < componentCount; ++i) {
+					auto componentType = readComponentName(stream);
+					if (!componentType.has_value()) return std::nullopt;
+					loadedArchetype.componentTypes.push_back(componentType.value());
+				}
+
+				// More rows than entities can be created would fail later on anyway.
+				uint64_t rowCount = 0;
+				if (!readBinary(stream, rowCount)) return std::nullopt;
+				if (rowCount > entityManager->getCreatableEntityCount()) return std::nullopt;
+				loadedArchetype.rowCount = rowCount;
+				for (const auto &componentType: loadedArchetype.componentTypes) {
+					auto &codec = componentCodecs.at(componentType);
+					auto collection = codec.createCollection();
+					if (!codec.readColumn(*collection, loadedArchetype.rowCount, stream)) return std::nullopt;
+					loadedArchetype.collections.push_back(std::move(collection));
+				}
+			}
+
+			auto loadedEntities = std::vector<Entity>();
+			for (auto &loadedArchetype: loadedArchetypes) {
+				for (const auto &componentType: loadedArchetype.componentTypes) {
+					componentCodecs.at(componentType).registerComponent(*componentManager);
+				}
+				if (!insertArchetypeRows(loadedArchetype.componentTypes, std::move(loadedArchetype.collections),
+				                         loadedArchetype.rowCount, loadedEntities)) {
+					return std::nullopt;
+				}
+			}
+			return std::make_optional(loadedEntities);
+		}
+
+		/// Send an event to all systems. Events are delivered in bulk at the end of the tick and can be read during the
+		/// next tick.
+		/// \tparam T The event type.
+		/// \param event The event to send.
+		template<class T>
+		void sendEvent(const T &event) {
+			systemManager->getEventBus()->getChannel<T>().send(event);
+		}
+
+		/// Read all events of a type that have been delivered at the end of the last tick.
+		/// \tparam T The event type.
+		/// \return The events, valid until the next tick has finished.
+		template<class T>
+		std::span<const T> readEvents() {
+			return systemManager->getEventBus()->getChannel<T>().read();
+		}
+
+		/// Get the profiler that records the update calls of all systems. Profiling is disabled until it is enabled on the
+		/// profiler.
+		SystemProfiler &getProfiler() {
+			return systemManager->getProfiler();
+		}
+
+		/// Collect the memory usage and fragmentation of all archetypes, as well as entity and system statistics.
+		/// \return A snapshot of the current state of the world.
+		WorldStats stats() {
+			WorldStats worldStats;
+			for (const auto &signature: componentManager->getArchetypeSignatures()) {
+				auto archetype = componentManager->getArchetype(signature).value();
+				ArchetypeStats archetypeStats;
+				archetypeStats.signature = signature;
+				for (const auto &componentType: archetype->getComponentTypes()) {
+					archetypeStats.componentTypes.push_back(componentCodecs.contains(componentType)
+					                                        ? componentCodecs.at(componentType).name
+					                                        : componentType.name());
+				}
+				archetypeStats.rowCount = archetype->getRowCount();
+				archetypeStats.entityCount = signature == Signature(0)
+				                             ? entityManager->getAllEntitiesOfSignature(signature).size()
+				                             : archetype->getEntityCount();
+				archetypeStats.rowCapacity = archetype->getRowCapacity();
+				archetypeStats.bytes = archetype->getMemoryFootprint();
+				worldStats.componentBytes += archetypeStats.bytes;
+				worldStats.archetypes.push_back(std::move(archetypeStats));
+			}
+
+			worldStats.systems = systemManager->getSystemStats();
+			worldStats.entityCount = entityManager->getEntityCount();
+			worldStats.deadEntityCount = entityManager->getDeadEntityCount();
+			return worldStats;
+		}
+
+		/// Run the archetype maintenance pass. Vacant rows left behind by migrated and removed entities are erased,
+		/// over-allocated component collections are shrunk and archetypes without any rows are destroyed. The pass works
+		/// through the archetypes one after another and stops as soon as the time budget is used up, so it can be spread
+		/// over multiple frames. The next call continues where the last one stopped.
+		/// \param timeBudget The time this call may spend on the pass. At least one archetype is processed per call.
+		/// \return True if the pass has been completed, false if archetypes are left for the next call.
+		bool defragment(std::chrono::microseconds timeBudget = std::chrono::microseconds::max()) {
+			if (pendingDefragmentation.empty()) {
+				pendingDefragmentation = componentManager->getArchetypeSignatures();
+			}
+
+			auto startTime = std::chrono::steady_clock::now();
+			while (!pendingDefragmentation.empty()) {
+				Signature signature = pendingDefragmentation.back();
+				pendingDefragmentation.pop_back();
+				defragmentArchetype(signature);
+
+				auto elapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(
+						std::chrono::steady_clock::now() - startTime);
+				if (elapsedTime >= timeBudget) break;
+			}
+			return pendingDefragmentation.empty();
+		}
+
+		/// Run the sort pass of a component type. The rows of every archetype containing the component are ordered by a
+		/// key computed from it, e.g. computeMortonCode of a position or a material id, so systems visit entities with
+		/// close keys one after another. Vacant rows are moved behind all other rows. Like defragment, the pass works
+		/// through the archetypes one after another within a time budget and the next call continues where the last one
+		/// stopped. Archetypes that are already sorted are left untouched.
+		/// \tparam T The component type the key is computed from. Must derive from Component.
+		/// \param keyFunction Callable receiving const T & and returning a key that can be compared with <.
+		/// \param timeBudget The time this call may spend on the pass. At least one archetype is processed per call.
+		/// \return True if the pass has been completed, false if archetypes are left for the next call.
+		template<class T, class KeyFunction, class = typename std::enable_if<std::is_base_of<Component, T>::value>::type>
+		bool sortRows(KeyFunction keyFunction, std::chrono::microseconds timeBudget = std::chrono::microseconds::max()) {
+			auto &pendingSignatures = pendingSorts[typeid(T)];
+			if (pendingSignatures.empty()) {
+				for (const auto &signature: componentManager->getArchetypeSignatures()) {
+					if (componentManager->getArchetype(signature).value()->containsType<T>()) {
+						pendingSignatures.push_back(signature);
+					}
+				}
+			}
+
+			auto startTime = std::chrono::steady_clock::now();
+			while (!pendingSignatures.empty()) {
+				Signature signature = pendingSignatures.back();
+				pendingSignatures.pop_back();
+				sortArchetypeRows<T>(signature, keyFunction);
+
+				auto elapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(
+						std::chrono::steady_clock::now() - startTime);
+				if (elapsedTime >= timeBudget) break;
+			}
+			return pendingSignatures.empty();
+		}
+
+		/// Copy the entities, archetype columns and shared components of this world into a snapshot. The instances the
+		/// snapshot holds from a previous capture are overwritten in place, so capturing into the same snapshot every frame
+		/// only allocates for rows and archetypes that did not exist before. Columns that have neither been handed out for
+		/// writing nor changed otherwise since they have been captured into the snapshot are skipped, like writeDiff, writes
+		/// through instances handed out before that capture are not seen. Systems, prefabs, observers, events and spatial
+		/// indices are not part of the snapshot, spatial indices are rebuilt from the components on restore. Pending
+		/// reservations are committed first, so this must not run while other threads reserve entities.
+		/// \param snapshot The snapshot to overwrite.
+		void captureSnapshot(WorldSnapshot &snapshot) {
+			commitReservedEntities();
+			entityManager->captureState(snapshot.entityState);
+
+			std::erase_if(snapshot.archetypes, [this](const auto &archetypeEntry) {
+				return !componentManager->getArchetype(archetypeEntry.first).has_value();
+			});
+			for (const auto &signature: componentManager->getArchetypeSignatures()) {
+				auto archetype = componentManager->getArchetype(signature).value();
+				auto componentTypes = archetype->getComponentTypes();
+				auto &columns = snapshot.archetypes[signature];
+				if (columns.componentTypes != componentTypes) {
+					columns.componentTypes = componentTypes;
+					columns.collections.clear();
+					for (const auto &componentType: componentTypes) {
+						columns.collections.push_back(archetype->getCollection(componentType).value()->createNewAndEmpty());
+					}
+					columns.contentVersions.assign(componentTypes.size(), 0);
+				}
+				for (size_t i = 0; i < componentTypes.size(); ++i) {
+					auto collection = archetype->getCollection(componentTypes[i]).value();
+					uint64_t contentVersion = collection->getContentVersion();
+					if (columns.contentVersions[i] == contentVersion) continue;
+					collection->copyInto(*columns.collections[i]);
+					columns.contentVersions[i] = contentVersion;
+				}
+			}
+
+			std::erase_if(snapshot.sharedComponentStores, [this](const auto &storeEntry) {
+				return !sharedComponentStores.contains(storeEntry.first);
+			});
+			for (const auto &sharedComponentStore: sharedComponentStores) {
+				auto &snapshotStore = snapshot.sharedComponentStores[sharedComponentStore.first];
+				if (!snapshotStore) snapshotStore = sharedComponentStore.second->createNewAndEmpty();
+				sharedComponentStore.second->copyInto(*snapshotStore);
+			}
+			snapshot.captured = true;
+		}
+
+		/// Reset this world to the state captured in a snapshot. The component instances of the world are overwritten in
+		/// place where the rows still exist, archetypes created after the capture are emptied and the systems are linked to
+		/// the restored entities. Observers are not notified, the spatial indices are rebuilt from the restored components
+		/// instead. Entities created after the capture are uninitialized again, so the entities created after the restore get
+		/// the same indices as the first time.
+		/// \param snapshot The snapshot to restore. Must have been captured from this world.
+		/// \return False if nothing has been captured into the snapshot.
+		bool restoreSnapshot(const WorldSnapshot &snapshot) {
+			if (!snapshot.captured) return false;
+
+			for (const auto &signature: componentManager->getArchetypeSignatures()) {
+				if (snapshot.archetypes.contains(signature)) continue;
+				auto archetype = componentManager->getArchetype(signature).value();
+				for (const auto &componentType: archetype->getComponentTypes()) {
+					auto collection = archetype->getCollection(componentType).value();
+					collection->createNewAndEmpty()->copyInto(*collection);
+				}
+			}
+			for (const auto &[signature, columns]: snapshot.archetypes) {
+				auto archetypeResult = componentManager->getArchetype(signature);
+				if (archetypeResult.has_value()) {
+					for (size_t i = 0; i < columns.componentTypes.size(); ++i) {
+						columns.collections[i]->copyInto(*archetypeResult.value()->getCollection(columns.componentTypes[i]).value());
+					}
+					continue;
+				}
+
+				// The archetype has been destroyed by a defragmentation since the capture.
+				auto typedCollections = std::vector<std::pair<std::type_index, std::unique_ptr<ComponentInstanceCollection>>>();
+				for (size_t i = 0; i < columns.componentTypes.size(); ++i) {
+					auto collection = columns.collections[i]->createNewAndEmpty();
+					columns.collections[i]->copyInto(*collection);
+					typedCollections.emplace_back(columns.componentTypes[i], std::move(collection));
+				}
+				componentManager->insertArchetype(signature, Archetype::createFromCollections(std::move(typedCollections)));
+			}
+			entityManager->restoreState(snapshot.entityState);
+
+			for (auto &sharedComponentStore: sharedComponentStores) {
+				if (snapshot.sharedComponentStores.contains(sharedComponentStore.first)) continue;
+				sharedComponentStore.second = sharedComponentStore.second->createNewAndEmpty();
+			}
+			for (const auto &[componentType, snapshotStore]: snapshot.sharedComponentStores) {
+				auto &sharedComponentStore = sharedComponentStores[componentType];
+				if (!sharedComponentStore) sharedComponentStore = snapshotStore->createNewAndEmpty();
+				snapshotStore->copyInto(*sharedComponentStore);
+			}
+
+			// The links are rebuilt from the captured bookkeeping, which is faster than looking up every entity on its own.
+			systemManager->clearEntities();
+			for (const auto &[systemType, systemSignature]: systemManager->getSystemSignatures()) {
+				auto entitiesContainingSignature = std::unordered_map<Entity, std::tuple<Signature, size_t>>();
+				for (const auto &[entity, entitySignature]: snapshot.entityState.entitySignatureMap) {
+					if ((entitySignature & systemSignature) != systemSignature) continue;
+					entitiesContainingSignature[entity] = std::make_tuple(entitySignature,
+					                                                      snapshot.entityState.entityArchetypeIndexMap.at(entity));
+				}
+				systemManager->addEntitiesToSystem(systemType, entitiesContainingSignature);
+			}
+			systemManager->recordStructuralChange();
+
+			// The indices hold on to the replaced component instances of entities that may not even exist anymore.
+			for (const auto &rebuildSpatialIndex: spatialIndexRebuilders) {
+				rebuildSpatialIndex();
+			}
+			return true;
+		}
+
+
+		/// Write the changes a receiver has not seen yet as a compact binary diff, e.g. to replicate the world from a
+		/// dedicated server to its clients. The diff contains created and destroyed entities, components that have been
+		/// added or removed and the component instances that differ from the ones sent last. Plain components are compared
+		/// in chunks of WORLD_DIFF_CHUNK_SIZE bytes and only the changed chunks are written. Only components with a
+		/// registered codec are replicated.
+		/// Only the rows marked as changed are compared, so the cost follows the amount of changed rows instead of the size
+		/// of the world. Ticks that create, remove or move entities additionally compare the entity table once. Call
+		/// clearChangedRows() once the diffs of all receivers have been written for a tick.
+		/// \param baseline The state of the receiver, which is updated to the state the diff leads to.
+		/// \param stream The stream to write to.
+		/// \return True if the diff has been written, false if the stream failed or an instance of a custom codec is larger
+		/// than WORLD_DIFF_MAX_INSTANCE_SIZE. The baseline has to be reset after a failure.
+		bool writeDiff(DiffBaseline &baseline, std::ostream &stream) {
+			writeBinary(stream, WORLD_DIFF_MAGIC);
+			writeBinary(stream, WORLD_DIFF_VERSION);
+
+			// A baseline that has never been used has to receive every row, not just the changed ones.
+			bool sendAllRows = baseline.structureVersion == 0;
+			bool structureChanged = baseline.structureVersion != entityManager->getStructureVersion();
+			writeBinary(stream, static_cast<uint8_t>(structureChanged));
+			auto restructuredEntities = std::unordered_set<Entity>();
+			if (structureChanged) restructuredEntities = writeDiffStructure(baseline, stream);
+
+			const auto &rowEntities = getRowEntities();
+			auto blocks = std::unordered_map<std::type_index, DiffBlock>();
+			for (const auto &[signature, entities]: rowEntities) {
+				auto archetype = componentManager->getArchetype(signature).value();
+
+				// Entities that have been created or changed their components are sent completely.
+				auto restructuredRows = RowBitmask();
+				if (!restructuredEntities.empty()) {
+					for (size_t row = 0; row < entities.size(); ++row) {
+						if (restructuredEntities.contains(entities[row])) restructuredRows.set(row, true);
+					}
+				}
+
+				size_t wordCount = (archetype->getRowCount() + RowBitmask::BITS_PER_WORD - 1) / RowBitmask::BITS_PER_WORD;
+				for (const auto &componentType: archetype->getComponentTypes()) {
+					if (!componentCodecs.contains(componentType)) continue;
+					const auto &codec = componentCodecs.at(componentType);
+					auto &sentComponents = baseline.sentComponents[componentType];
+					auto &block = blocks[componentType];
+					auto collection = archetype->getCollection(componentType).value();
+					const auto &changedRows = collection->getChangedRows();
+					for (size_t wordIndex = 0; wordIndex < wordCount; ++wordIndex) {
+						uint64_t rowWord = sendAllRows ? ~uint64_t(0)
+						                               : changedRows.getWord(wordIndex) | restructuredRows.getWord(wordIndex);
+						while (rowWord != 0) {
+							size_t row = wordIndex * RowBitmask::BITS_PER_WORD + std::countr_zero(rowWord);
+							rowWord &= rowWord - 1;
+							if (row >= entities.size() || archetype->isRowVacant(row)) continue;
+							if (!writeDiffComponent(codec, *collection, row, entities[row], sentComponents, block)) {
+								return false;
+							}
+						}
+					}
+				}
+			}
+
+			uint32_t blockCount = 0;
+			for (const auto &block: blocks) {
+				if (block.second.entryCount > 0) blockCount++;
+			}
+			writeBinary(stream, blockCount);
+			for (const auto &[componentType, block]: blocks) {
+				if (block.entryCount == 0) continue;
+				const auto &name = componentCodecs.at(componentType).name;
+				writeBinary(stream, static_cast<uint32_t>(name.size()));
+				stream.write(name.data(), static_cast<std::streamsize>(name.size()));
+				writeBinary(stream, block.entryCount);
+				auto data = block.data.str();
+				stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+			}
+			return stream.good();
+		}
+
+		/// Apply a diff written by writeDiff() of another world. Entities are created and destroyed, components are added
+		/// and removed and the changed parts of the component instances are overwritten in place. The diffs of a sender
+		/// have to be applied in the order they have been written. The diff is applied while it is read, so a world that
+		/// received broken data has to be synchronized again with a reset baseline.
+		/// \param stream The stream to read from.
+		/// \param entityMap The entities created for the entities of the sender. Must be the same for every diff of a sender.
+		/// \return False if the data is invalid or a component type has no codec.
+		bool applyDiff(std::istream &stream, DiffEntityMap &entityMap) {
+			uint32_t magic = 0;
+			uint32_t version = 0;
+			uint8_t structureChanged = 0;
+			if (!readBinary(stream, magic) || !readBinary(stream, version) || !readBinary(stream, structureChanged)) {
+				return false;
+			}
+			if (magic != WORLD_DIFF_MAGIC || version != WORLD_DIFF_VERSION) return false;
+			if (structureChanged != 0 && !applyDiffStructure(stream, entityMap)) return false;
+
+			uint32_t blockCount = 0;
+			if (!readBinary(stream, blockCount)) return false;
+			for (uint32_t blockIndex = 0; blockIndex < blockCount; ++blockIndex) {
+				auto componentType = readComponentName(stream);
+				if (!componentType.has_value()) return false;
+				const auto &codec = componentCodecs.at(componentType.value());
+
+				uint32_t entryCount = 0;
+				if (!readBinary(stream, entryCount)) return false;
+				for (uint32_t entryIndex = 0; entryIndex < entryCount; ++entryIndex) {
+					uint64_t remoteEntity = 0;
+					if (!readBinary(stream, remoteEntity)) return false;
+					auto localEntity = entityMap.getLocalEntity(remoteEntity);
+					if (!localEntity.has_value()) return false;
+					auto signature = entityManager->getSignature(localEntity.value());
+					auto archetypeIndex = entityManager->getArchetypeIndex(localEntity.value());
+					if (!signature.has_value() || !archetypeIndex.has_value()) return false;
+					auto collection = componentManager->getArchetype(signature.value()).value()->getCollection(componentType.value());
+					if (!collection.has_value()) return false;
+					if (!readDiffComponent(codec, *collection.value(), archetypeIndex.value(), stream)) return false;
+				}
+			}
+			return true;
+		}
+
+		/// Forget which rows have changed. Rows are marked as changed whenever their instances are handed out for writing,
+		/// e.g. by getComponent or forEachEnabled, and when entities are added to an archetype. The spatial indices are
+		/// refreshed first, as they only read the positions of changed rows.
+		void clearChangedRows() {
+			refreshSpatialIndices();
+			for (const auto &signature: componentManager->getArchetypeSignatures()) {
+				auto archetype = componentManager->getArchetype(signature).value();
+				for (const auto &componentType: archetype->getComponentTypes()) {
+					archetype->getCollection(componentType).value()->clearChangedRows();
+				}
+			}
 		}
 
 
@@ -167,6 +1253,499 @@ class World {
 		std::shared_ptr<ComponentManager> componentManager;
 		std::unique_ptr<SystemManager> systemManager;
 
+		std::vector<Signature> pendingDefragmentation;
+		std::unordered_map<std::type_index, std::vector<Signature>> pendingSorts;
+
+		std::optional<std::chrono::steady_clock::time_point> lastTickTime;
+
+		std::vector<std::unique_ptr<Archetype>> prefabArchetypes;
+
+		std::unordered_map<std::type_index, ComponentCodec> componentCodecs;
+		std::unordered_map<std::string, std::type_index> componentCodecNames;
+		size_t longestCodecNameLength = 0;
+
+		/// The entity of every archetype row, rebuilt once the structure of the entity manager has changed.
+		std::unordered_map<Signature, std::vector<Entity>> rowEntities;
+		uint64_t rowEntitiesVersion = 0;
+
+		/// The entries of a component type inside a world diff, collected before the block is written.
+		struct DiffBlock {
+			uint32_t entryCount = 0;
+			std::ostringstream data;
+		};
+
+		std::unordered_map<std::type_index, std::vector<ComponentObserver>> addObservers;
+		std::unordered_map<std::type_index, std::vector<ComponentObserver>> removeObservers;
+
+		std::unordered_map<std::type_index, std::unique_ptr<SharedComponentStoreBase>> sharedComponentStores;
+
+		std::unordered_map<std::type_index, std::shared_ptr<SpatialGrid>> spatialIndices;
+		std::vector<std::function<void()>> spatialIndexRefreshers;
+		std::vector<std::function<void()>> spatialIndexRebuilders;
+
+		template<class T>
+		void registerComponentIfMissing() {
+			if (!componentManager->isComponentRegistred(typeid(T))) {
+				componentManager->registerComponent<T>();
+			}
+		}
+
+		template<SharedComponent T>
+		SharedComponentStore<T> &getSharedComponentStore() {
+			auto &sharedComponentStore = sharedComponentStores[typeid(T)];
+			if (!sharedComponentStore) sharedComponentStore = std::make_unique<SharedComponentStore<T>>();
+			return static_cast<SharedComponentStore<T> &>(*sharedComponentStore);
+		}
+
+		/// Call all observers of a component type with one batch of entities.
+		void notifyObservers(const std::unordered_map<std::type_index, std::vector<ComponentObserver>> &observers,
+		                     std::type_index componentType, std::span<const Entity> entities) {
+			if (entities.empty()) return;
+			auto observersResult = observers.find(componentType);
+			if (observersResult == observers.end()) return;
+			for (const auto &observer: observersResult->second) {
+				observer(entities);
+			}
+		}
+
+		/// Create entities for rows of components that have been built outside of the archetypes. The collections are
+		/// handed over to a new archetype or appended to the existing archetype of their signature and all systems are
+		/// linked to the new entities at once. The add observers of every component type are called once with all new entities.
+		/// \param componentTypes The component type of every collection.
+		/// \param collections The collections holding the components of the new entities. All must have rowCount entries.
+		/// \param rowCount The amount of entities to create.
+		/// \param createdEntities The list the created entities are appended to.
+		/// \return False if a component type is not registered or no more entities can be created.
+		bool insertArchetypeRows(const std::vector<std::type_index> &componentTypes,
+		                         std::vector<std::unique_ptr<ComponentInstanceCollection>> collections, size_t rowCount,
+		                         std::vector<Entity> &createdEntities) {
+			auto signatureResult = componentManager->getCombinedSignatureOfTypes(componentTypes);
+			if (!signatureResult.has_value()) return false;
+			Signature signature = signatureResult.value();
+
+			// Either hand the collections over to a new archetype or append them to the existing one.
+			size_t firstRow = 0;
+			auto archetypeResult = componentManager->getArchetype(signature);
+			if (archetypeResult.has_value()) {
+				firstRow = archetypeResult.value()->getRowCount();
+				for (size_t i = 0; i < componentTypes.size(); ++i) {
+					archetypeResult.value()->getCollection(componentTypes[i]).value()->append(*collections[i]);
+				}
+			} else {
+				auto typedCollections = std::vector<std::pair<std::type_index, std::unique_ptr<ComponentInstanceCollection>>>();
+				for (size_t i = 0; i < componentTypes.size(); ++i) {
+					typedCollections.emplace_back(componentTypes[i], std::move(collections[i]));
+				}
+				componentManager->insertArchetype(signature, Archetype::createFromCollections(std::move(typedCollections)));
+			}
+
+			auto newEntityAccessors = std::unordered_map<Entity, std::tuple<Signature, size_t>>();
+			newEntityAccessors.reserve(rowCount);
+			entityManager->reserve(rowCount);
+			for (size_t row = 0; row < rowCount; ++row) {
+				auto entityResult = entityManager->createEntity();
+				if (!entityResult.has_value()) return false;
+				size_t archetypeIndex = signature == Signature(0) ? 0 : firstRow + row;
+				entityManager->assignNewSignature(entityResult.value(), signature, archetypeIndex);
+				newEntityAccessors[entityResult.value()] = std::make_tuple(signature, archetypeIndex);
+				createdEntities.push_back(entityResult.value());
+				systemManager->recordStructuralChange();
+			}
+			for (const auto &systemId: systemManager->getSystemsMatchingSignature(signature)) {
+				systemManager->addEntitiesToSystem(systemId, newEntityAccessors);
+			}
+
+			auto insertedEntities = std::span<const Entity>(createdEntities).last(rowCount);
+			for (const auto &componentType: componentTypes) {
+				notifyObservers(addObservers, componentType, insertedEntities);
+			}
+			return true;
+		}
+
+		/// Collect the signatures of all archetypes that have to be saved and check that all their components have a codec.
+		/// \param plainOnly True if only plain codecs can be used.
+		/// \return The signatures to save or nullopt if a component cannot be saved.
+		std::optional<std::vector<Signature>> collectSavedSignatures(bool plainOnly) {
+			auto savedSignatures = std::vector<Signature>();
+			for (const auto &signature: componentManager->getArchetypeSignatures()) {
+				auto archetype = componentManager->getArchetype(signature).value();
+				for (const auto &componentType: archetype->getComponentTypes()) {
+					if (!componentCodecs.contains(componentType) ||
+					    (plainOnly && componentCodecs.at(componentType).packedSize == 0)) return std::nullopt;
+				}
+				if (signature == Signature(0) || archetype->getEntityCount() > 0) savedSignatures.push_back(signature);
+			}
+			return std::make_optional(savedSignatures);
+		}
+
+		/// Collect all rows of an archetype that are not vacant. The root archetype has no rows, all of its entities share
+		/// index 0, so one placeholder row per entity is returned instead.
+		std::vector<size_t> getOccupiedRows(Signature signature) {
+			if (signature == Signature(0)) {
+				return std::vector<size_t>(entityManager->getAllEntitiesOfSignature(signature).size(), 0);
+			}
+
+			auto archetype = componentManager->getArchetype(signature).value();
+			auto rows = std::vector<size_t>();
+			rows.reserve(archetype->getRowCount());
+			for (size_t row = 0; row < archetype->getRowCount(); ++row) {
+				if (!archetype->isRowVacant(row)) rows.push_back(row);
+			}
+			return rows;
+		}
+
+		void writeComponentNames(std::ostream &stream, const std::vector<std::type_index> &componentTypes) {
+			writeBinary(stream, static_cast<uint32_t>(componentTypes.size()));
+			for (const auto &componentType: componentTypes) {
+				const auto &name = componentCodecs.at(componentType).name;
+				writeBinary(stream, static_cast<uint32_t>(name.size()));
+				stream.write(name.data(), static_cast<std::streamsize>(name.size()));
+			}
+		}
+
+		template<bool MarkRowsChanged, class... T, class Callback>
+		void visitEnabledRows(Callback &&callback) {
+			auto requiredSignatureResult = componentManager->getCombinedSignatureOfTypes({typeid(T)...});
+			if (!requiredSignatureResult.has_value()) return;
+			Signature requiredSignature = requiredSignatureResult.value();
+
+			for (const auto &signature: componentManager->getArchetypeSignatures()) {
+				if ((signature & requiredSignature) != requiredSignature) continue;
+				auto archetype = componentManager->getArchetype(signature).value();
+				size_t rowCount = archetype->getRowCount();
+
+				auto collections = std::make_tuple(archetype->getCollection(typeid(T)).value()...);
+				// The lists are only read, the rows handed out for writing are marked as changed one by one.
+				auto componentLists = std::make_tuple(&std::any_cast<std::reference_wrapper<const std::vector<std::shared_ptr<T>>>>(
+						archetype->getCollection(typeid(T)).value()->as_any_const()).get()...);
+				for (size_t wordIndex = 0; wordIndex * RowBitmask::BITS_PER_WORD < rowCount; ++wordIndex) {
+					uint64_t disabledWord = 0;
+					std::apply([&disabledWord, wordIndex](auto *... collection) {
+						((disabledWord |= collection->getDisabledRows().getWord(wordIndex)), ...);
+					}, collections);
+
+					size_t remainingRows = rowCount - wordIndex * RowBitmask::BITS_PER_WORD;
+					uint64_t enabledWord = ~disabledWord;
+					if (remainingRows < RowBitmask::BITS_PER_WORD) enabledWord &= (uint64_t(1) << remainingRows) - 1;
+
+					while (enabledWord != 0) {
+						size_t row = wordIndex * RowBitmask::BITS_PER_WORD + std::countr_zero(enabledWord);
+						enabledWord &= enabledWord - 1;
+						// Vacant rows are not disabled, they have lost their instances when their entity migrated.
+						if ((((*std::get<const std::vector<std::shared_ptr<T>> *>(componentLists))[row] == nullptr) || ...)) continue;
+						if constexpr (MarkRowsChanged) {
+							std::apply([row](auto *... collection) { (collection->markChanged(row), ...); }, collections);
+						}
+						callback(*(*std::get<const std::vector<std::shared_ptr<T>> *>(componentLists))[row]...);
+					}
+				}
+			}
+		}
+
+		template<class T>
+		ComponentCodec addEntityFunctions(ComponentCodec codec) {
+			codec.addToEntity = [](World &world, Entity entity) { world.addComponent<T>(entity); };
+			codec.removeFromEntity = [](World &world, Entity entity) { world.removeComponent<T>(entity); };
+			return codec;
+		}
+
+		const std::unordered_map<Signature, std::vector<Entity>> &getRowEntities() {
+			if (rowEntitiesVersion != entityManager->getStructureVersion()) {
+				rowEntities = entityManager->getRowEntities();
+				rowEntitiesVersion = entityManager->getStructureVersion();
+			}
+			return rowEntities;
+		}
+
+		/// Write the entities that have been destroyed, created or have changed their components since the baseline.
+		/// Components are referred to by their index in a table of codec names written in front of the entities. An index
+		/// that has been destroyed and recycled since the baseline is written as destroyed and created again, so the
+		/// receiver does not mistake the new entity for the old one.
+		/// \return The entities that have been created or have changed their components.
+		std::unordered_set<Entity> writeDiffStructure(DiffBaseline &baseline, std::ostream &stream) {
+			const auto &entityGenerations = entityManager->getEntityGenerations();
+			auto getGeneration = [](const std::unordered_map<Entity, uint32_t> &generations, Entity entity) {
+				auto generationResult = generations.find(entity);
+				return generationResult != generations.end() ? generationResult->second : 0;
+			};
+
+			auto destroyedEntities = std::vector<Entity>();
+			auto recycledEntities = std::unordered_set<Entity>();
+			for (const auto &entitySignature: baseline.entitySignatures) {
+				Entity entity = entitySignature.first;
+				if (!entityManager->getEntitySignatures().contains(entity)) {
+					destroyedEntities.push_back(entity);
+				} else if (getGeneration(entityGenerations, entity) != getGeneration(baseline.entityGenerations, entity)) {
+					destroyedEntities.push_back(entity);
+					recycledEntities.insert(entity);
+				}
+			}
+
+			auto nameTable = std::vector<std::type_index>();
+			auto nameIndices = std::unordered_map<std::type_index, uint16_t>();
+			auto signatureNameIndices = std::unordered_map<Signature, std::vector<uint16_t>>();
+			auto restructuredEntities = std::unordered_set<Entity>();
+			auto entries = std::ostringstream();
+			for (const auto &[entity, signature]: entityManager->getEntitySignatures()) {
+				auto sentSignature = baseline.entitySignatures.find(entity);
+				if (sentSignature != baseline.entitySignatures.end() && sentSignature->second == signature &&
+				    !recycledEntities.contains(entity)) {
+					continue;
+				}
+				restructuredEntities.insert(entity);
+
+				if (!signatureNameIndices.contains(signature)) {
+					auto &indices = signatureNameIndices[signature];
+					if (signature != Signature(0)) {
+						for (const auto &componentType: componentManager->getArchetype(signature).value()->getComponentTypes()) {
+							if (!componentCodecs.contains(componentType)) continue;
+							if (!nameIndices.contains(componentType)) {
+								nameIndices[componentType] = static_cast<uint16_t>(nameTable.size());
+								nameTable.push_back(componentType);
+							}
+							indices.push_back(nameIndices.at(componentType));
+						}
+					}
+				}
+				const auto &indices = signatureNameIndices.at(signature);
+				writeBinary(entries, static_cast<uint64_t>(entity));
+				writeBinary(entries, static_cast<uint16_t>(indices.size()));
+				for (const uint16_t nameIndex: indices) {
+					writeBinary(entries, nameIndex);
+				}
+			}
+
+			writeComponentNames(stream, nameTable);
+			writeBinary(stream, static_cast<uint32_t>(destroyedEntities.size()));
+			for (const Entity entity: destroyedEntities) {
+				writeBinary(stream, static_cast<uint64_t>(entity));
+			}
+			writeBinary(stream, static_cast<uint32_t>(restructuredEntities.size()));
+			auto entryData = entries.str();
+			stream.write(entryData.data(), static_cast<std::streamsize>(entryData.size()));
+
+			// Entities with new components get all of their components again, the index of a destroyed entity may be reused.
+			for (auto &sentComponents: baseline.sentComponents) {
+				for (const Entity entity: destroyedEntities) {
+					sentComponents.second.erase(entity);
+				}
+				for (const Entity entity: restructuredEntities) {
+					sentComponents.second.erase(entity);
+				}
+			}
+			baseline.entitySignatures = entityManager->getEntitySignatures();
+			baseline.entityGenerations = entityGenerations;
+			baseline.structureVersion = entityManager->getStructureVersion();
+			return restructuredEntities;
+		}
+
+		/// Write the instance of a row if it differs from the one sent last and remember it as sent.
+		/// \return False if the instance is too large to be received.
+		bool writeDiffComponent(const ComponentCodec &codec, ComponentInstanceCollection &collection, size_t row,
+		                        Entity entity, std::unordered_map<Entity, std::string> &sentComponents, DiffBlock &block) {
+			auto sentComponent = sentComponents.find(entity);
+			if (codec.packedSize == 0) {
+				auto instanceStream = std::ostringstream();
+				codec.writeColumn(collection, {row}, instanceStream);
+				auto instance = instanceStream.str();
+				if (instance.size() > WORLD_DIFF_MAX_INSTANCE_SIZE) return false;
+				if (sentComponent != sentComponents.end() && sentComponent->second == instance) return true;
+
+				writeBinary(block.data, static_cast<uint64_t>(entity));
+				writeBinary(block.data, static_cast<uint32_t>(instance.size()));
+				block.data.write(instance.data(), static_cast<std::streamsize>(instance.size()));
+				block.entryCount++;
+				sentComponents.insert_or_assign(entity, std::move(instance));
+				return true;
+			}
+
+			auto instance = std::string(codec.packedSize, '\0');
+			codec.packColumn(collection, {row}, reinterpret_cast<std::byte *>(instance.data()));
+			const std::string *sentInstance = sentComponent != sentComponents.end() ? &sentComponent->second : nullptr;
+
+			// One bit per chunk tells the receiver which chunks follow.
+			size_t chunkCount = (codec.packedSize + WORLD_DIFF_CHUNK_SIZE - 1) / WORLD_DIFF_CHUNK_SIZE;
+			auto chunkMask = std::vector<uint8_t>((chunkCount + 7) / 8);
+			bool hasChanged = false;
+			for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+				size_t offset = chunk * WORLD_DIFF_CHUNK_SIZE;
+				size_t chunkSize = std::min(WORLD_DIFF_CHUNK_SIZE, codec.packedSize - offset);
+				if (sentInstance && sentInstance->compare(offset, chunkSize, instance, offset, chunkSize) == 0) continue;
+				chunkMask[chunk / 8] |= uint8_t(1) << (chunk % 8);
+				hasChanged = true;
+			}
+			if (!hasChanged) return true;
+
+			writeBinary(block.data, static_cast<uint64_t>(entity));
+			block.data.write(reinterpret_cast<const char *>(chunkMask.data()), static_cast<std::streamsize>(chunkMask.size()));
+			for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+				if ((chunkMask[chunk / 8] & (uint8_t(1) << (chunk % 8))) == 0) continue;
+				size_t offset = chunk * WORLD_DIFF_CHUNK_SIZE;
+				size_t chunkSize = std::min(WORLD_DIFF_CHUNK_SIZE, codec.packedSize - offset);
+				block.data.write(instance.data() + offset, static_cast<std::streamsize>(chunkSize));
+			}
+			block.entryCount++;
+			sentComponents.insert_or_assign(entity, std::move(instance));
+			return true;
+		}
+
+		/// Read the entities written by writeDiffStructure and bring the entities of this world in line with them.
+		bool applyDiffStructure(std::istream &stream, DiffEntityMap &entityMap) {
+			uint32_t nameCount = 0;
+			if (!readBinary(stream, nameCount)) return false;
+			auto nameTable = std::vector<std::type_index>();
+			for (uint32_t i = 0; i < nameCount; ++i) {
+				auto componentType = readComponentName(stream);
+				if (!componentType.has_value()) return false;
+				nameTable.push_back(componentType.value());
+			}
+
+			uint32_t destroyedCount = 0;
+			if (!readBinary(stream, destroyedCount)) return false;
+			for (uint32_t i = 0; i < destroyedCount; ++i) {
+				uint64_t remoteEntity = 0;
+				if (!readBinary(stream, remoteEntity)) return false;
+				auto localEntity = entityMap.localEntities.find(remoteEntity);
+				if (localEntity == entityMap.localEntities.end()) continue;
+				removeEntity(localEntity->second);
+				entityMap.localEntities.erase(localEntity);
+			}
+
+			uint32_t entityCount = 0;
+			if (!readBinary(stream, entityCount)) return false;
+			for (uint32_t i = 0; i < entityCount; ++i) {
+				uint64_t remoteEntity = 0;
+				uint16_t componentCount = 0;
+				if (!readBinary(stream, remoteEntity) || !readBinary(stream, componentCount)) return false;
+				auto componentTypes = std::unordered_set<std::type_index>();
+				for (uint16_t j = 0; j < componentCount; ++j) {
+					uint16_t nameIndex = 0;
+					if (!readBinary(stream, nameIndex) || nameIndex >= nameTable.size()) return false;
+					componentTypes.insert(nameTable[nameIndex]);
+				}
+
+				auto localEntity = entityMap.getLocalEntity(remoteEntity);
+				if (!localEntity.has_value()) {
+					localEntity = createNewEntity();
+					if (!localEntity.has_value()) return false;
+					entityMap.localEntities[remoteEntity] = localEntity.value();
+				}
+
+				// Only components with a codec are replicated, all others are left as they are.
+				auto signature = entityManager->getSignature(localEntity.value()).value();
+				if (signature != Signature(0)) {
+					for (const auto &componentType: componentManager->getArchetype(signature).value()->getComponentTypes()) {
+						if (!componentCodecs.contains(componentType)) continue;
+						if (componentTypes.erase(componentType) == 0) {
+							componentCodecs.at(componentType).removeFromEntity(*this, localEntity.value());
+						}
+					}
+				}
+				for (const auto &componentType: componentTypes) {
+					componentCodecs.at(componentType).addToEntity(*this, localEntity.value());
+				}
+			}
+			return true;
+		}
+
+		/// Read an instance written by writeDiffComponent into an existing row.
+		bool readDiffComponent(const ComponentCodec &codec, ComponentInstanceCollection &collection, size_t row,
+		                       std::istream &stream) {
+			if (codec.packedSize == 0) {
+				uint32_t instanceSize = 0;
+				if (!readBinary(stream, instanceSize) || instanceSize > WORLD_DIFF_MAX_INSTANCE_SIZE) return false;
+				auto instance = std::string(instanceSize, '\0');
+				stream.read(instance.data(), instanceSize);
+				if (stream.fail()) return false;
+				auto instanceStream = std::istringstream(std::move(instance));
+				if (!codec.readRow(collection, row, instanceStream)) return false;
+				collection.markChanged(row);
+				return true;
+			}
+
+			size_t chunkCount = (codec.packedSize + WORLD_DIFF_CHUNK_SIZE - 1) / WORLD_DIFF_CHUNK_SIZE;
+			auto chunkMask = std::vector<uint8_t>((chunkCount + 7) / 8);
+			stream.read(reinterpret_cast<char *>(chunkMask.data()), static_cast<std::streamsize>(chunkMask.size()));
+			if (stream.fail()) return false;
+
+			// The changed chunks are patched into the current instance.
+			auto instance = std::vector<std::byte>(codec.packedSize);
+			codec.packColumn(collection, {row}, instance.data());
+			for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+				if ((chunkMask[chunk / 8] & (uint8_t(1) << (chunk % 8))) == 0) continue;
+				size_t offset = chunk * WORLD_DIFF_CHUNK_SIZE;
+				size_t chunkSize = std::min(WORLD_DIFF_CHUNK_SIZE, codec.packedSize - offset);
+				stream.read(reinterpret_cast<char *>(instance.data() + offset), static_cast<std::streamsize>(chunkSize));
+				if (stream.fail()) return false;
+			}
+			codec.unpackRow(collection, row, instance.data());
+			collection.markChanged(row);
+			return true;
+		}
+
+		/// Read a component name written by writeComponentNames and look up the codec registered for it. Names longer than
+		/// every registered one are rejected before anything is allocated for them.
+		/// \return The component type or nullopt if the name is unknown or the stream failed.
+		std::optional<std::type_index> readComponentName(std::istream &stream) {
+			uint32_t nameLength = 0;
+			if (!readBinary(stream, nameLength) || nameLength > longestCodecNameLength) return std::nullopt;
+			auto name = std::string(nameLength, '\0');
+			stream.read(name.data(), nameLength);
+			if (stream.fail() || !componentCodecNames.contains(name)) return std::nullopt;
+			return std::make_optional(componentCodecNames.at(name));
+		}
+
+		void addComponentCodec(std::type_index componentType, ComponentCodec codec) {
+			longestCodecNameLength = std::max(longestCodecNameLength, codec.name.size());
+			componentCodecNames.insert_or_assign(codec.name, componentType);
+			componentCodecs.insert_or_assign(componentType, std::move(codec));
+		}
+
+		void defragmentArchetype(Signature signature) {
+			auto rowRemapResult = componentManager->compactArchetype(signature);
+			if (!rowRemapResult.has_value()) return;
+
+			// The entities keep their row order, so only the indices of entities behind a vacant row have changed.
+			for (const Entity entity: entityManager->remapArchetypeIndices(signature, rowRemapResult.value())) {
+				auto newArchetypeIndex = entityManager->getArchetypeIndex(entity).value();
+				systemManager->updateEntityReference(entity, signature, newArchetypeIndex);
+			}
+
+			componentManager->removeArchetypeIfEmpty(signature);
+		}
+
+		template<class T, class KeyFunction>
+		void sortArchetypeRows(Signature signature, KeyFunction &keyFunction) {
+			// The archetype may have been destroyed since the pass has started.
+			auto archetypeResult = componentManager->getArchetype(signature);
+			if (!archetypeResult.has_value() || !archetypeResult.value()->containsType<T>()) return;
+			auto archetype = archetypeResult.value();
+
+			typedef std::invoke_result_t<KeyFunction &, const T &> Key;
+			const auto &componentList = std::any_cast<std::reference_wrapper<const std::vector<std::shared_ptr<T>>>>(
+					archetype->getCollection(typeid(T)).value()->as_any_const()).get();
+			auto keys = std::vector<std::optional<Key>>();
+			keys.reserve(componentList.size());
+			for (const auto &component: componentList) {
+				keys.push_back(component ? std::make_optional<Key>(keyFunction(*component)) : std::nullopt);
+			}
+
+			// Vacant rows have no key and go last, rows with equal keys keep their order.
+			auto isOrdered = [&keys](size_t a, size_t b) {
+				if (!keys[b].has_value()) return keys[a].has_value();
+				return keys[a].has_value() && keys[a].value() < keys[b].value();
+			};
+			auto rowOrder = std::vector<size_t>(keys.size());
+			std::iota(rowOrder.begin(), rowOrder.end(), 0);
+			if (std::is_sorted(rowOrder.begin(), rowOrder.end(), isOrdered)) return;
+			std::stable_sort(rowOrder.begin(), rowOrder.end(), isOrdered);
+
+			auto rowRemap = archetype->reorderRows(rowOrder);
+			for (const Entity entity: entityManager->remapArchetypeIndices(signature, rowRemap)) {
+				systemManager->updateEntityReference(entity, signature, entityManager->getArchetypeIndex(entity).value());
+			}
+		}
+
 		std::unordered_map<Entity, std::tuple<Signature, size_t>>
 		getAllEntitiesThatHaveThisSignature(const std::vector<Entity> &entitiesToCheck, Signature requestedSignature) {
 
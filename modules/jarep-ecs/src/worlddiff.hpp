@@ -0,0 +1,76 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_WORLDDIFF_HPP
+#define JAREP_WORLDDIFF_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include "entity.hpp"
+#include "signature.hpp"
+
+/// Identifies a binary world diff. The values are stored in the native byte order of the machine that wrote them.
+const uint32_t WORLD_DIFF_MAGIC = 0x4644454A; // "JEDF"
+const uint32_t WORLD_DIFF_VERSION = 1;
+
+/// The amount of bytes of a packed plain component that are compared and sent together. A changed member only costs the
+/// chunks it overlaps plus one mask bit per chunk of the component.
+const size_t WORLD_DIFF_CHUNK_SIZE = 4;
+
+/// The largest instance of a component with a custom codec a diff may contain. The size of such an instance is read from
+/// the data, so the receiver rejects larger ones instead of allocating whatever a broken packet announces.
+const size_t WORLD_DIFF_MAX_INSTANCE_SIZE = 1024 * 1024;
+
+/// The state a receiver is known to have, kept by the sender of World::writeDiff. Every receiver, e.g. every client of a
+/// dedicated server, needs a baseline of its own. A new baseline makes the first diff contain the whole world.
+class DiffBaseline {
+
+	public:
+		/// Forget everything that has been sent, so the next diff contains the whole world again, e.g. after a receiver
+		/// has lost its state.
+		void reset() {
+			structureVersion = 0;
+			entitySignatures.clear();
+			entityGenerations.clear();
+			sentComponents.clear();
+		}
+
+	private:
+		/// The structure version of the entity manager when the entities have been sent last.
+		uint64_t structureVersion = 0;
+		std::unordered_map<Entity, Signature> entitySignatures;
+		/// The generations of the entity indices when the entities have been sent last.
+		std::unordered_map<Entity, uint32_t> entityGenerations;
+		/// The bytes of every component instance that have been sent last, by component type and entity.
+		std::unordered_map<std::type_index, std::unordered_map<Entity, std::string>> sentComponents;
+
+		friend class World;
+};
+
+/// Maps the entities of the sender of world diffs to the entities World::applyDiff has created for them. Entity indices
+/// are assigned by every world on its own, so the receiver has to translate them.
+class DiffEntityMap {
+
+	public:
+		/// Get the entity of the receiving world that mirrors an entity of the sender.
+		/// \param remoteEntity The entity of the sender.
+		/// \return The local entity or nullopt if the entity has not been received or has been destroyed.
+		[[nodiscard]] std::optional<Entity> getLocalEntity(Entity remoteEntity) const {
+			auto localEntityResult = localEntities.find(remoteEntity);
+			if (localEntityResult == localEntities.end()) return std::nullopt;
+			return std::make_optional(localEntityResult->second);
+		}
+
+		[[nodiscard]] size_t size() const { return localEntities.size(); }
+
+	private:
+		std::unordered_map<Entity, Entity> localEntities;
+
+		friend class World;
+};
+
+#endif //JAREP_WORLDDIFF_HPP
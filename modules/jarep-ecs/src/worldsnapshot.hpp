@@ -0,0 +1,45 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_WORLDSNAPSHOT_HPP
+#define JAREP_WORLDSNAPSHOT_HPP
+
+#include <cstdint>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+#include "componentInstanceCollection.hpp"
+#include "entitymanager.hpp"
+#include "sharedcomponentstore.hpp"
+#include "signature.hpp"
+
+/// A copy of the entities, archetype columns and shared components of a world, captured with World::captureSnapshot and
+/// restored with World::restoreSnapshot. A snapshot keeps its component instances between captures and overwrites them in
+/// place, so capturing a world whose structure has not changed since the last capture does not allocate. Columns whose
+/// content version has not changed since they have been captured into this snapshot are not copied again.
+class WorldSnapshot {
+
+	public:
+		/// Check if a world has been captured into this snapshot.
+		[[nodiscard]] bool isCaptured() const { return captured; }
+
+	private:
+		/// The columns of a single archetype, in the order of its component types.
+		struct ArchetypeColumns {
+			std::vector<std::type_index> componentTypes;
+			std::vector<std::unique_ptr<ComponentInstanceCollection>> collections;
+			/// The content version of the world column each collection has been copied from.
+			std::vector<uint64_t> contentVersions;
+		};
+
+		bool captured = false;
+		EntityManagerState entityState;
+		std::unordered_map<Signature, ArchetypeColumns> archetypes;
+		std::unordered_map<std::type_index, std::unique_ptr<SharedComponentStoreBase>> sharedComponentStores;
+
+		friend class World;
+};
+
+#endif //JAREP_WORLDSNAPSHOT_HPP
@@ -0,0 +1,49 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_WORLDSTATS_HPP
+#define JAREP_WORLDSTATS_HPP
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "signature.hpp"
+
+/// Memory and occupancy of a single archetype.
+struct ArchetypeStats {
+	Signature signature;
+	/// The names of all component types, ordered by their collection in the archetype.
+	std::vector<std::string> componentTypes;
+	/// The amount of rows, including vacant rows left behind by migrated and removed entities.
+	size_t rowCount = 0;
+	/// The amount of rows that still belong to an entity.
+	size_t entityCount = 0;
+	/// The amount of rows the component collections can hold before they have to reallocate.
+	size_t rowCapacity = 0;
+	/// The amount of bytes the component collections and their component instances occupy.
+	size_t bytes = 0;
+};
+
+/// Membership and cost of a single system.
+struct SystemStats {
+	std::string systemType;
+	/// The amount of entities linked to the system, regardless of how many of them its update visits.
+	size_t linkedEntityCount = 0;
+	/// The wall time of the latest update call of the system.
+	std::chrono::nanoseconds lastUpdateDuration = std::chrono::nanoseconds(0);
+};
+
+/// Snapshot of the memory usage and fragmentation of a world.
+struct WorldStats {
+	std::vector<ArchetypeStats> archetypes;
+	std::vector<SystemStats> systems;
+	/// The amount of living entities.
+	size_t entityCount = 0;
+	/// The amount of entity ids that are dead and wait for being recycled.
+	size_t deadEntityCount = 0;
+	/// The sum of the bytes of all archetypes.
+	size_t componentBytes = 0;
+};
+
+#endif //JAREP_WORLDSTATS_HPP
@@ -14,6 +14,8 @@
 #include "../src/archetype.hpp"
 #include "component.hpp"
 
+// Test-local component types, kept in an anonymous namespace so they do not clash with same-named types of other test files.
+namespace {
 class ComponentA : public Component{
 
     public:
@@ -34,6 +36,7 @@ class ComponentB : public Component{
         int value;
         std::string text;
 };
+}
 
 TEST_CASE("Archetype - Create an empty Archetype and add new components and remove them.") {
 
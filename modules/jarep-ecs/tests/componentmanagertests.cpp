@@ -13,6 +13,8 @@
 #include "../src/componentmanager.hpp"
 #include "../src/signature.hpp"
 
+// Test-local component types, kept in an anonymous namespace so they do not clash with same-named types of other test files.
+namespace {
 class ComponentA : public Component {
 	public:
 		ComponentA() {
@@ -35,6 +37,7 @@ class ComponentB : public Component {
 
 		float value;
 };
+}
 
 static Signature componentASignature = Signature(1);
 static Signature componentBSignature = Signature(2);
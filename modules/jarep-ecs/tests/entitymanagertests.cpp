@@ -11,6 +11,8 @@
 
 #include "../src/entitymanager.hpp"
 #include <memory>
+#include <thread>
+#include <unordered_set>
 
 class EntityManagerTestFriend{
 	public:
@@ -109,3 +111,90 @@ TEST_CASE("Entity Manager - Assign new Signature - Signature is available as lon
 	auto entity02 = entityManager->createEntity().value();
 	REQUIRE_FALSE(entityManager->getSignature(entity02).has_value());
 }
+
+TEST_CASE("Entity Manager - Reserving entities") {
+	auto entityManager = std::make_shared<EntityManager>();
+	auto removedEntities = std::vector<Entity>();
+	for (int i = 0; i < 100; ++i) {
+		auto entity = entityManager->createEntity().value();
+		entityManager->assignNewSignature(entity, Signature(0), 0);
+		removedEntities.push_back(entity);
+	}
+	for (const Entity entity: removedEntities) {
+		entityManager->removeEntity(entity);
+	}
+
+	SECTION("Reserve entities from multiple threads - All reserved entities are unique and dead ones are recycled") {
+		auto threads = std::vector<std::thread>();
+		for (int threadIndex = 0; threadIndex < 4; ++threadIndex) {
+			threads.emplace_back([&entityManager]() {
+				for (int i = 0; i < 1000; ++i) {
+					entityManager->reserveEntity();
+				}
+			});
+		}
+		for (auto &thread: threads) {
+			thread.join();
+		}
+
+		auto reservedEntities = entityManager->collectReservedEntities();
+		REQUIRE(reservedEntities.size() == 4000);
+		auto uniqueEntities = std::unordered_set<Entity>(reservedEntities.begin(), reservedEntities.end());
+		REQUIRE(uniqueEntities.size() == 4000);
+		for (const Entity entity: removedEntities) {
+			REQUIRE(uniqueEntities.contains(entity));
+		}
+		REQUIRE(entityManager->getDeadEntityCount() == 0);
+		REQUIRE(entityManager->collectReservedEntities().empty());
+	}
+
+	SECTION("Check entities while other threads reserve - Recycled entities are dead until they are reserved") {
+		auto reservingThread = std::thread([&entityManager]() {
+			for (int i = 0; i < 80; ++i) {
+				entityManager->reserveEntity();
+			}
+		});
+		// A recycled entity stays alive once it has been reserved.
+		auto aliveRemovedEntities = std::unordered_set<Entity>();
+		while (aliveRemovedEntities.size() < 80) {
+			for (const Entity entity: removedEntities) {
+				if (entityManager->isAlive(entity)) {
+					aliveRemovedEntities.insert(entity);
+				} else {
+					REQUIRE_FALSE(aliveRemovedEntities.contains(entity));
+				}
+			}
+		}
+		reservingThread.join();
+
+		REQUIRE(entityManager->getDeadEntityCount() == 20);
+		REQUIRE(entityManager->collectReservedEntities().size() == 80);
+		REQUIRE(entityManager->getDeadEntityCount() == 20);
+	}
+
+	SECTION("Collect reservations - Unused recycled entities are returned to the dead entities") {
+		auto reservedEntity = entityManager->reserveEntity().value();
+		REQUIRE(entityManager->isAlive(reservedEntity));
+		REQUIRE(entityManager->getDeadEntityCount() == 99);
+
+		entityManager->collectReservedEntities();
+		REQUIRE(entityManager->getDeadEntityCount() == 99);
+		REQUIRE(entityManager->createEntity().has_value());
+		REQUIRE(entityManager->getDeadEntityCount() == 98);
+	}
+
+	SECTION("Reserve from more managers than a thread caches - Every manager collects its own reservations") {
+		auto entityManagers = std::vector<std::unique_ptr<EntityManager>>();
+		for (int managerIndex = 0; managerIndex < 10; ++managerIndex) {
+			entityManagers.push_back(std::make_unique<EntityManager>());
+		}
+		for (int round = 0; round < 3; ++round) {
+			for (const auto &otherEntityManager: entityManagers) {
+				REQUIRE(otherEntityManager->reserveEntity().has_value());
+			}
+		}
+		for (const auto &otherEntityManager: entityManagers) {
+			REQUIRE(otherEntityManager->collectReservedEntities().size() == 3);
+		}
+	}
+}
@@ -0,0 +1,70 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#if __APPLE__
+#include <catch2/catch_test_macros.hpp>
+#else
+
+#include <catch2/catch.hpp>
+
+#endif
+
+#include "../src/spatialgrid.hpp"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+static std::vector<Entity> sorted(std::vector<Entity> entities) {
+	std::sort(entities.begin(), entities.end());
+	return entities;
+}
+
+TEST_CASE("Spatial Grid") {
+	auto grid = SpatialGrid(10.0f);
+	grid.update(0, SpatialPoint{0.0f, 0.0f, 0.0f});
+	grid.update(1, SpatialPoint{5.0f, 5.0f, 0.0f});
+	grid.update(2, SpatialPoint{25.0f, 0.0f, 0.0f});
+	grid.update(3, SpatialPoint{-15.0f, -15.0f, -15.0f});
+
+	SECTION("Query a radius - Only entities within the distance are returned") {
+		REQUIRE(sorted(grid.queryRadius(SpatialPoint{0.0f, 0.0f, 0.0f}, 8.0f)) == std::vector<Entity>{0, 1});
+		REQUIRE(sorted(grid.queryRadius(SpatialPoint{0.0f, 0.0f, 0.0f}, 6.0f)) == std::vector<Entity>{0});
+		REQUIRE(grid.queryRadius(SpatialPoint{100.0f, 0.0f, 0.0f}, 6.0f).empty());
+	}
+
+	SECTION("Query a box - Entities on the boundary are included") {
+		REQUIRE(sorted(grid.queryAABB(SpatialPoint{-20.0f, -20.0f, -20.0f}, SpatialPoint{0.0f, 0.0f, 0.0f})) ==
+		        std::vector<Entity>{0, 3});
+		REQUIRE(sorted(grid.queryAABB(SpatialPoint{-1e6f, -1e6f, -1e6f}, SpatialPoint{1e6f, 1e6f, 1e6f})) ==
+		        std::vector<Entity>{0, 1, 2, 3});
+	}
+
+	SECTION("Move and remove entities - Queries and cells follow the changes") {
+		REQUIRE(grid.getCellCount() == 3);
+		grid.update(2, SpatialPoint{1.0f, 1.0f, 1.0f});
+		REQUIRE(grid.getCellCount() == 2);
+		REQUIRE(sorted(grid.queryRadius(SpatialPoint{0.0f, 0.0f, 0.0f}, 2.0f)) == std::vector<Entity>{0, 2});
+
+		grid.remove(0);
+		grid.remove(0);
+		REQUIRE(grid.size() == 3);
+		REQUIRE_FALSE(grid.getPosition(0).has_value());
+		REQUIRE(grid.queryRadius(SpatialPoint{0.0f, 0.0f, 0.0f}, 2.0f) == std::vector<Entity>{2});
+	}
+
+	SECTION("Insert extreme positions - Far away positions are clamped and non-finite ones are skipped") {
+		const float infinity = std::numeric_limits<float>::infinity();
+		const float nan = std::numeric_limits<float>::quiet_NaN();
+		grid.update(4, SpatialPoint{3e38f, -3e38f, 0.0f});
+		grid.update(5, SpatialPoint{nan, 0.0f, 0.0f});
+		grid.update(0, SpatialPoint{0.0f, infinity, 0.0f});
+		REQUIRE(grid.size() == 4);
+		REQUIRE_FALSE(grid.getPosition(0).has_value());
+		REQUIRE_FALSE(grid.getPosition(5).has_value());
+
+		REQUIRE(grid.queryAABB(SpatialPoint{1e38f, -infinity, -1.0f}, SpatialPoint{infinity, -1e38f, 1.0f}) ==
+		        std::vector<Entity>{4});
+		REQUIRE(grid.queryRadius(SpatialPoint{nan, 0.0f, 0.0f}, 10.0f).empty());
+	}
+}
@@ -12,6 +12,9 @@
 #endif
 
 #include "systemmanager.hpp"
+#include <sstream>
+#include <thread>
+#include <algorithm>
 
 class TestSystemA : public System {
 	public:
@@ -20,10 +23,12 @@ class TestSystemA : public System {
 		};
 		~TestSystemA() override = default;
 		int systemCalls;
+		std::chrono::nanoseconds lastDeltaTime = std::chrono::nanoseconds(0);
 
 	protected:
 		void update() override {
 			systemCalls++;
+			lastDeltaTime = getDeltaTime();
 		}
 };
 
@@ -105,4 +110,151 @@ TEST_CASE("System Manager") {
 		REQUIRE_FALSE(result.has_value());
 
 	}
-}
\ No newline at end of file
+}
+
+TEST_CASE("System Profiler") {
+	auto profiler = SystemProfiler(3);
+	profiler.setEnabled(true);
+
+	SECTION("Record more samples than the capacity - Oldest samples are overwritten") {
+		for (uint64_t frame = 0; frame < 5; ++frame) {
+			SystemProfileSample sample;
+			sample.frame = frame;
+			profiler.record(sample);
+		}
+		auto samples = profiler.getSamples();
+		REQUIRE(samples.size() == 3);
+		REQUIRE(samples[0].frame == 2);
+		REQUIRE(samples[2].frame == 4);
+	}
+
+	SECTION("Record while disabled - Sample is ignored") {
+		profiler.setEnabled(false);
+		profiler.record(SystemProfileSample());
+		REQUIRE(profiler.getSamples().empty());
+	}
+
+	SECTION("Export without samples - Empty trace") {
+		std::stringstream trace;
+		profiler.exportChromeTrace(trace);
+		REQUIRE(trace.str() == "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[]}");
+	}
+}
+
+struct TestEvent {
+	int value;
+};
+
+TEST_CASE("Event Bus") {
+	auto eventBus = EventBus();
+	auto &channel = eventBus.getChannel<TestEvent>();
+
+	SECTION("Send event - Event is readable only after publishing") {
+		channel.send(TestEvent{1});
+		REQUIRE(channel.read().empty());
+		eventBus.publish();
+		REQUIRE(channel.read().size() == 1);
+		REQUIRE(channel.read()[0].value == 1);
+		eventBus.publish();
+		REQUIRE(channel.read().empty());
+	}
+
+	SECTION("Send events from multiple threads - All events are delivered") {
+		auto threads = std::vector<std::thread>();
+		for (int threadIndex = 0; threadIndex < 4; ++threadIndex) {
+			threads.emplace_back([&channel, threadIndex]() {
+				for (int i = 0; i < 1000; ++i) {
+					channel.send(TestEvent{threadIndex});
+				}
+			});
+		}
+		for (auto &thread: threads) {
+			thread.join();
+		}
+		eventBus.publish();
+
+		auto events = channel.read();
+		REQUIRE(events.size() == 4000);
+		int sum = 0;
+		for (const auto &event: events) {
+			sum += event.value;
+		}
+		REQUIRE(sum == 6000);
+	}
+
+	SECTION("Send to more buses than a thread caches - Every event reaches its own bus") {
+		auto eventBuses = std::vector<std::unique_ptr<EventBus>>();
+		for (int busIndex = 0; busIndex < 10; ++busIndex) {
+			eventBuses.push_back(std::make_unique<EventBus>());
+		}
+		for (int round = 0; round < 3; ++round) {
+			for (int busIndex = 0; busIndex < 10; ++busIndex) {
+				eventBuses[busIndex]->getChannel<TestEvent>().send(TestEvent{busIndex});
+			}
+		}
+		for (int busIndex = 0; busIndex < 10; ++busIndex) {
+			eventBuses[busIndex]->publish();
+			auto events = eventBuses[busIndex]->getChannel<TestEvent>().read();
+			REQUIRE(events.size() == 3);
+			REQUIRE(std::all_of(events.begin(), events.end(), [busIndex](const TestEvent &event) {
+				return event.value == busIndex;
+			}));
+		}
+	}
+}
+
+TEST_CASE("System Run Conditions") {
+	auto systemManager = std::make_unique<SystemManager>();
+	systemManager->registerSystem<TestSystemA>(Signature(0), nullptr);
+	auto testSystem = dynamic_cast<const TestSystemA *>(systemManager->getSystem(typeid(TestSystemA)).value());
+
+	SECTION("Set a condition for an unregistered system - Condition is rejected") {
+		REQUIRE_FALSE(systemManager->setRunCondition(typeid(TestSystemB), SystemRunCondition()));
+	}
+
+	SECTION("Require entities - System is skipped while no entity matches") {
+		SystemRunCondition runCondition;
+		runCondition.requireEntities = true;
+		REQUIRE(systemManager->setRunCondition(typeid(TestSystemA), runCondition));
+		systemManager->update();
+		REQUIRE(testSystem->systemCalls == 0);
+
+		auto entities = std::unordered_map<Entity, std::tuple<Signature, size_t>>();
+		entities[Entity(3)] = std::make_tuple(Signature(0), 0);
+		systemManager->addEntitiesToSystem(typeid(TestSystemA), entities);
+		systemManager->update();
+		REQUIRE(testSystem->systemCalls == 1);
+	}
+
+	SECTION("Run every third tick - System is updated on every third tick only") {
+		SystemRunCondition runCondition;
+		runCondition.interval = 3;
+		systemManager->setRunCondition(typeid(TestSystemA), runCondition);
+		for (int i = 0; i < 7; ++i) {
+			systemManager->update(std::chrono::milliseconds(16));
+		}
+		REQUIRE(testSystem->systemCalls == 3);
+
+		// The system sees the time of the two skipped ticks as well.
+		for (int i = 0; i < 3; ++i) {
+			systemManager->update(std::chrono::milliseconds(16));
+		}
+		REQUIRE(testSystem->systemCalls == 4);
+		REQUIRE(testSystem->lastDeltaTime == std::chrono::milliseconds(48));
+	}
+
+	SECTION("Skip unchanged versions - System is only updated after the version has changed") {
+		uint64_t resourceVersion = 0;
+		SystemRunCondition runCondition;
+		runCondition.changeVersion = [&resourceVersion]() { return resourceVersion; };
+		systemManager->setRunCondition(typeid(TestSystemA), runCondition);
+		systemManager->update();
+		systemManager->update();
+		REQUIRE(testSystem->systemCalls == 1);
+
+		resourceVersion++;
+		systemManager->update();
+		systemManager->update();
+		REQUIRE(testSystem->systemCalls == 2);
+	}
+}
@@ -10,10 +10,22 @@
 #endif
 
 #include "../src/world.hpp"
+#include "../src/simulationrunner.hpp"
+#include "../src/snapshotring.hpp"
+#include "../src/extractionbuffer.hpp"
 #include <vector>
 #include <typeindex>
 #include <memory>
 #include <optional>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <array>
+#include <map>
+#include <set>
+#include <algorithm>
 
 class MyTestComponent : public Component {
 	public:
@@ -37,6 +49,28 @@ class MyInvalidTestComponent : public Component{
 		int myTestValue;
 };
 
+class MyPlainTestComponent : public Component {
+	public:
+		static constexpr bool isPlainData = true;
+
+		float x = 0.0f;
+		float y = 0.0f;
+		int id = 0;
+};
+
+class MyAlignedPlainTestComponent : public Component {
+	public:
+		static constexpr bool isPlainData = true;
+
+		float a = 0.0f;
+		alignas(16) float b[4] = {};
+};
+
+class MyNamedTestComponent : public Component {
+	public:
+		std::string name;
+};
+
 class MyTestSystem : public System {
 
 	public:
@@ -66,6 +100,106 @@ class MyTestSystem : public System {
 };
 
 
+class MySpawningTestSystem : public System {
+	public:
+		static inline World *spawnWorld = nullptr;
+
+	protected:
+		void update() override {
+			spawnWorld->createNewEntity();
+		}
+};
+
+class MyCountingTestSystem : public System {
+	public:
+		static inline int updateCount = 0;
+		static inline std::chrono::nanoseconds lastDeltaTime = std::chrono::nanoseconds(0);
+
+	protected:
+		void update() override {
+			updateCount++;
+			lastDeltaTime = getDeltaTime();
+		}
+};
+
+class MySecondCountingTestSystem : public System {
+	public:
+		static inline int updateCount = 0;
+
+	protected:
+		void update() override {
+			updateCount++;
+		}
+};
+
+struct MyTestDamageEvent {
+	Entity target;
+	int damage;
+};
+
+class MyDamageSendingTestSystem : public System {
+	protected:
+		void update() override {
+			sendEvent(MyTestDamageEvent{1, 5});
+		}
+};
+
+class MyDamageReceivingTestSystem : public System {
+	public:
+		static inline int receivedDamage = 0;
+
+	protected:
+		void update() override {
+			for (const auto &event: readEvents<MyTestDamageEvent>()) {
+				receivedDamage += event.damage;
+			}
+		}
+};
+
+class MyCacheLineTestComponent : public Component {
+	public:
+		static constexpr size_t alignment = 64;
+
+		float value = 0.0f;
+};
+
+class alignas(32) MyOverAlignedTestComponent : public Component {
+	public:
+		float values[8] = {};
+};
+
+class MyPositionTestComponent : public Component {
+	public:
+		static constexpr auto soaFields() {
+			return std::array{&MyPositionTestComponent::x, &MyPositionTestComponent::y, &MyPositionTestComponent::z};
+		}
+
+		float x = 0.0f;
+		float y = 0.0f;
+		float z = 0.0f;
+};
+
+class MyVelocityTestComponent : public Component {
+	public:
+		static constexpr auto soaFields() {
+			return std::array{&MyVelocityTestComponent::x, &MyVelocityTestComponent::y, &MyVelocityTestComponent::z};
+		}
+
+		float x = 0.0f;
+		float y = 0.0f;
+		float z = 0.0f;
+};
+
+class MyThreadSafeCountingTestSystem : public System {
+	public:
+		static inline std::atomic<int> updateCount = 0;
+
+	protected:
+		void update() override {
+			updateCount++;
+		}
+};
+
 class WorldFriendAccessor {
 	public:
 		static bool hasEntityExpectedValues(std::shared_ptr<World> &world, Entity &entityToCheck, bool isAlive,
@@ -94,7 +228,7 @@ class WorldFriendAccessor {
 		                               std::shared_ptr<MyTestComponent> &testComponent) {
 			auto availableComponents = world->componentManager->archetypeSignatureMap[archetypeSignature]->getComponentsWithEntities<MyTestComponent>();
 			for (const auto &availableComponent: availableComponents) {
-				if (availableComponent->myTestValue == testComponent->myTestValue) {
+				if (availableComponent && availableComponent->myTestValue == testComponent->myTestValue) {
 					return true;
 				}
 			}
@@ -122,6 +256,16 @@ class WorldFriendAccessor {
 			return storedComponent.value()->myTestValue == expectedTestValue;
 		}
 
+		template<class T>
+		static size_t getChangedRowCount(std::shared_ptr<World> &world) {
+			size_t changedRowCount = 0;
+			for (const auto &signature: world->componentManager->getArchetypeSignatures()) {
+				auto collection = world->componentManager->getArchetype(signature).value()->getCollection(typeid(T));
+				if (collection.has_value()) changedRowCount += collection.value()->getChangedRows().count();
+			}
+			return changedRowCount;
+		}
+
 		static bool isEntityAlive(std::shared_ptr<World> &world, Entity &entity) {
 			return world->entityManager->isAlive(entity);
 		}
@@ -206,6 +350,31 @@ class WorldFriendAccessor {
 			                              world->entityManager->entityArchetypeIndexMap[entity]);
 			world->systemManager->addEntitiesToSystem(typeid(MyTestSystem), map);
 		}
+
+		template<class T>
+		static std::optional<std::shared_ptr<T>> getComponent(std::shared_ptr<World> &world, Entity entity) {
+			auto signature = world->entityManager->getSignature(entity).value();
+			auto archetypeIndex = world->entityManager->getArchetypeIndex(entity).value();
+			auto archetype = world->componentManager->archetypeSignatureMap[signature].get();
+			if (!archetype->containsType<T>()) return std::nullopt;
+			return archetype->getComponent<T>(archetypeIndex);
+		}
+
+		static size_t getEntityCount(std::shared_ptr<World> &world) {
+			return world->entityManager->getAllActiveEntities().size();
+		}
+
+		static bool hasArchetype(std::shared_ptr<World> &world, Signature signature) {
+			return world->componentManager->archetypeSignatureMap.contains(signature);
+		}
+
+		static size_t getArchetypeRowCount(std::shared_ptr<World> &world, Signature signature) {
+			return world->componentManager->archetypeSignatureMap[signature]->getRowCount();
+		}
+
+		static size_t getArchetypeRowCapacity(std::shared_ptr<World> &world, Signature signature) {
+			return world->componentManager->archetypeSignatureMap[signature]->getRowCapacity();
+		}
 };
 
 TEST_CASE("World - Add Entities") {
@@ -259,6 +428,16 @@ TEST_CASE("World - Remove Entities") {
 		REQUIRE(WorldFriendAccessor::isEntitySignatureAndIndexCorrect(world, entityC, 30));
 		REQUIRE(WorldFriendAccessor::doesSystemReferesToEntity(world, entityC));
 	}
+
+	SECTION("Remove valid entity - The row is left vacant and the other rows stay in place until defragmentation") {
+		world->removeEntity(entityB);
+		REQUIRE(WorldFriendAccessor::hasEntityExpectedValues(world, entityC, true, Signature(1), 2));
+
+		REQUIRE(world->defragment());
+		REQUIRE(WorldFriendAccessor::hasEntityExpectedValues(world, entityC, true, Signature(1), 1));
+		REQUIRE(WorldFriendAccessor::isEntitySignatureAndIndexCorrect(world, entityC, 30));
+		REQUIRE(WorldFriendAccessor::doesSystemReferesToEntity(world, entityC));
+	}
 }
 
 TEST_CASE("World - Add Component") {
@@ -421,4 +600,1468 @@ TEST_CASE("World - Remove System") {
 		REQUIRE_NOTHROW(world->deregisterSystem<MyTestSystem>());
 	}
 
-}
\ No newline at end of file
+}
+
+TEST_CASE("World - Defragment") {
+	auto world = std::make_shared<World>();
+	auto entities = std::vector<Entity>();
+	for (int i = 0; i < 4; ++i) {
+		auto entity = world->createNewEntity().value();
+		world->addComponent<MyTestComponent>(entity);
+		entities.push_back(entity);
+	}
+	const auto testComponentSignature = Signature(1);
+	const auto combinedSignature = Signature(3);
+
+	// Migrate the first two entities away, which leaves two vacant rows in the archetype of the test component.
+	world->addComponent<MyInvalidTestComponent>(entities[0]);
+	world->addComponent<MyInvalidTestComponent>(entities[1]);
+	REQUIRE(WorldFriendAccessor::getArchetypeRowCount(world, testComponentSignature) == 4);
+
+	SECTION("Defragment with vacant rows - Rows get erased and the remaining entities stay valid") {
+		REQUIRE(world->defragment());
+		REQUIRE(WorldFriendAccessor::getArchetypeRowCount(world, testComponentSignature) == 2);
+		REQUIRE(WorldFriendAccessor::getArchetypeRowCapacity(world, testComponentSignature) == 2);
+		REQUIRE(WorldFriendAccessor::hasEntityExpectedValues(world, entities[2], true, testComponentSignature, 0));
+		REQUIRE(WorldFriendAccessor::hasEntityExpectedValues(world, entities[3], true, testComponentSignature, 1));
+		REQUIRE(WorldFriendAccessor::hasEntityExpectedValues(world, entities[0], true, combinedSignature, 0));
+		REQUIRE(WorldFriendAccessor::hasEntityExpectedValues(world, entities[1], true, combinedSignature, 1));
+	}
+
+	SECTION("Defragment with only vacant rows - Empty archetype gets destroyed") {
+		world->addComponent<MyInvalidTestComponent>(entities[2]);
+		world->addComponent<MyInvalidTestComponent>(entities[3]);
+		REQUIRE(world->defragment());
+		REQUIRE_FALSE(WorldFriendAccessor::hasArchetype(world, testComponentSignature));
+		REQUIRE(WorldFriendAccessor::hasArchetype(world, Signature(0)));
+		REQUIRE(WorldFriendAccessor::getArchetypeRowCount(world, combinedSignature) == 4);
+
+		// Entities can still migrate into the destroyed archetype, which recreates it.
+		world->removeComponent<MyInvalidTestComponent>(entities[0]);
+		REQUIRE(WorldFriendAccessor::hasEntityExpectedValues(world, entities[0], true, testComponentSignature, 0));
+	}
+
+	SECTION("Defragment with zero time budget - Pass is spread over multiple calls") {
+		int calls = 1;
+		while (!world->defragment(std::chrono::microseconds(0))) {
+			calls++;
+		}
+		REQUIRE(calls > 1);
+		REQUIRE(WorldFriendAccessor::getArchetypeRowCount(world, testComponentSignature) == 2);
+	}
+}
+
+TEST_CASE("World - Save and load") {
+	auto world = std::make_shared<World>();
+	world->registerComponentCodec<MyPlainTestComponent>("MyPlainTestComponent");
+	world->registerComponentCodec<MyNamedTestComponent>(
+			"MyNamedTestComponent",
+			[](const MyNamedTestComponent &component, std::ostream &stream) {
+				writeBinary(stream, static_cast<uint32_t>(component.name.size()));
+				stream.write(component.name.data(), static_cast<std::streamsize>(component.name.size()));
+			},
+			[](std::istream &stream, MyNamedTestComponent &component) {
+				uint32_t length = 0;
+				readBinary(stream, length);
+				component.name.resize(length);
+				stream.read(component.name.data(), length);
+			});
+
+	auto plainEntity = world->createNewEntity().value();
+	world->addComponent<MyPlainTestComponent>(plainEntity);
+	auto namedEntity = world->createNewEntity().value();
+	world->addComponent<MyPlainTestComponent>(namedEntity);
+	world->addComponent<MyNamedTestComponent>(namedEntity);
+	world->createNewEntity();
+
+	auto plainComponent = WorldFriendAccessor::getComponent<MyPlainTestComponent>(world, plainEntity).value();
+	plainComponent->x = 1.5f;
+	plainComponent->y = -2.0f;
+	plainComponent->id = 7;
+	WorldFriendAccessor::getComponent<MyPlainTestComponent>(world, namedEntity).value()->id = 8;
+	WorldFriendAccessor::getComponent<MyNamedTestComponent>(world, namedEntity).value()->name = "Named";
+
+	SECTION("Save and load into a new world - All entities and component values are restored") {
+		std::stringstream stream;
+		REQUIRE(world->save(stream));
+
+		auto loadedWorld = std::make_shared<World>();
+		loadedWorld->registerComponentCodec<MyPlainTestComponent>("MyPlainTestComponent");
+		loadedWorld->registerComponentCodec<MyNamedTestComponent>(
+				"MyNamedTestComponent",
+				[](const MyNamedTestComponent &, std::ostream &) {},
+				[](std::istream &stream, MyNamedTestComponent &component) {
+					uint32_t length = 0;
+					readBinary(stream, length);
+					component.name.resize(length);
+					stream.read(component.name.data(), length);
+				});
+		REQUIRE(loadedWorld->registerSystem<MyTestSystem>({}));
+
+		auto loadedEntities = loadedWorld->load(stream);
+		REQUIRE(loadedEntities.has_value());
+		REQUIRE(loadedEntities.value().size() == 3);
+
+		int plainOnly = 0;
+		int named = 0;
+		for (auto entity: loadedEntities.value()) {
+			auto plainResult = WorldFriendAccessor::getComponent<MyPlainTestComponent>(loadedWorld, entity);
+			auto namedResult = WorldFriendAccessor::getComponent<MyNamedTestComponent>(loadedWorld, entity);
+			if (namedResult.has_value()) {
+				REQUIRE(namedResult.value()->name == "Named");
+				REQUIRE(plainResult.value()->id == 8);
+				named++;
+			} else if (plainResult.has_value()) {
+				REQUIRE(plainResult.value()->x == 1.5f);
+				REQUIRE(plainResult.value()->y == -2.0f);
+				REQUIRE(plainResult.value()->id == 7);
+				plainOnly++;
+			}
+			REQUIRE(WorldFriendAccessor::doesSystemReferesToEntity(loadedWorld, entity));
+		}
+		REQUIRE(plainOnly == 1);
+		REQUIRE(named == 1);
+	}
+
+	SECTION("Load into the same world - Loaded rows are appended to the existing archetypes") {
+		std::stringstream stream;
+		REQUIRE(world->save(stream));
+		auto loadedEntities = world->load(stream);
+		REQUIRE(loadedEntities.has_value());
+
+		for (auto entity: loadedEntities.value()) {
+			auto plainResult = WorldFriendAccessor::getComponent<MyPlainTestComponent>(world, entity);
+			if (plainResult.has_value() && plainResult.value()->id == 7) {
+				// Row 1 is the vacant row the second entity left behind when it migrated to its final archetype.
+				REQUIRE(WorldFriendAccessor::hasEntityExpectedValues(world, entity, true, Signature(1), 2));
+			}
+		}
+		REQUIRE(WorldFriendAccessor::getComponent<MyPlainTestComponent>(world, plainEntity).value()->id == 7);
+	}
+
+	SECTION("Save and load an over-aligned component - Members in front of the aligned one are kept") {
+		world->registerComponentCodec<MyAlignedPlainTestComponent>("MyAlignedPlainTestComponent");
+		world->addComponent<MyAlignedPlainTestComponent>(plainEntity);
+		auto alignedComponent = WorldFriendAccessor::getComponent<MyAlignedPlainTestComponent>(world, plainEntity).value();
+		alignedComponent->a = 3.0f;
+		alignedComponent->b[3] = 4.0f;
+
+		std::stringstream stream;
+		REQUIRE(world->save(stream));
+		auto loadedWorld = std::make_shared<World>();
+		loadedWorld->registerComponentCodec<MyPlainTestComponent>("MyPlainTestComponent");
+		loadedWorld->registerComponentCodec<MyNamedTestComponent>(
+				"MyNamedTestComponent",
+				[](const MyNamedTestComponent &, std::ostream &) {},
+				[](std::istream &stream, MyNamedTestComponent &component) {
+					uint32_t length = 0;
+					readBinary(stream, length);
+					component.name.resize(length);
+					stream.read(component.name.data(), length);
+				});
+		loadedWorld->registerComponentCodec<MyAlignedPlainTestComponent>("MyAlignedPlainTestComponent");
+		auto loadedEntities = loadedWorld->load(stream);
+		REQUIRE(loadedEntities.has_value());
+
+		size_t alignedCount = 0;
+		for (auto entity: loadedEntities.value()) {
+			auto alignedResult = WorldFriendAccessor::getComponent<MyAlignedPlainTestComponent>(loadedWorld, entity);
+			if (!alignedResult.has_value()) continue;
+			REQUIRE(alignedResult.value()->a == 3.0f);
+			REQUIRE(alignedResult.value()->b[3] == 4.0f);
+			alignedCount++;
+		}
+		REQUIRE(alignedCount == 1);
+	}
+
+	SECTION("Save with a component without codec - Saving fails") {
+		world->addComponent<MyTestComponent>(plainEntity);
+		std::stringstream stream;
+		REQUIRE_FALSE(world->save(stream));
+	}
+
+	SECTION("Load invalid data - Loading fails and no entities are created") {
+		std::stringstream stream;
+		REQUIRE(world->save(stream));
+		auto truncatedStream = std::stringstream(stream.str().substr(0, stream.str().size() - 2));
+		auto worldToLoad = std::make_shared<World>();
+		worldToLoad->registerComponentCodec<MyPlainTestComponent>("MyPlainTestComponent");
+		REQUIRE_FALSE(worldToLoad->load(truncatedStream).has_value());
+		REQUIRE(WorldFriendAccessor::getEntityCount(worldToLoad) == 0);
+	}
+
+	SECTION("Load corrupt counts - Loading fails without allocating for the counts") {
+		auto writeHeader = [](std::ostream &stream) {
+			writeBinary(stream, WORLD_SNAPSHOT_MAGIC);
+			writeBinary(stream, WORLD_SNAPSHOT_VERSION);
+			writeBinary(stream, std::numeric_limits<uint32_t>::max());
+			writeBinary(stream, uint32_t(1));
+		};
+		std::stringstream longNameStream;
+		writeHeader(longNameStream);
+		writeBinary(longNameStream, std::numeric_limits<uint32_t>::max());
+		REQUIRE_FALSE(world->load(longNameStream).has_value());
+
+		std::stringstream manyRowsStream;
+		writeHeader(manyRowsStream);
+		std::string name = "MyPlainTestComponent";
+		writeBinary(manyRowsStream, static_cast<uint32_t>(name.size()));
+		manyRowsStream.write(name.data(), static_cast<std::streamsize>(name.size()));
+		writeBinary(manyRowsStream, std::numeric_limits<uint64_t>::max() / 2);
+		REQUIRE_FALSE(world->load(manyRowsStream).has_value());
+
+		std::stringstream truncatedRowsStream;
+		writeHeader(truncatedRowsStream);
+		writeBinary(truncatedRowsStream, static_cast<uint32_t>(name.size()));
+		truncatedRowsStream.write(name.data(), static_cast<std::streamsize>(name.size()));
+		writeBinary(truncatedRowsStream, uint64_t(1000000));
+		REQUIRE_FALSE(world->load(truncatedRowsStream).has_value());
+		REQUIRE(WorldFriendAccessor::getEntityCount(world) == 3);
+	}
+}
+
+TEST_CASE("World - Save and map level") {
+	auto world = std::make_shared<World>();
+	world->registerComponentCodec<MyPlainTestComponent>("MyPlainTestComponent");
+	for (int i = 0; i < 3; ++i) {
+		auto entity = world->createNewEntity().value();
+		world->addComponent<MyPlainTestComponent>(entity);
+		WorldFriendAccessor::getComponent<MyPlainTestComponent>(world, entity).value()->id = i;
+	}
+	auto levelPath = (std::filesystem::temp_directory_path() / "jarep_ecs_level_test.bin").string();
+
+	SECTION("Save and map level - Columns are page aligned and entities get restored from the mapping") {
+		{
+			auto file = std::ofstream(levelPath, std::ios::binary);
+			REQUIRE(world->saveLevel(file));
+		}
+
+		auto levelResult = MappedLevel::open(levelPath);
+		REQUIRE(levelResult.has_value());
+		auto &level = levelResult.value();
+		REQUIRE(level->getArchetypes().size() == 2);
+
+		size_t plainArchetypeIndex = level->getArchetypes()[0].componentNames.empty() ? 1 : 0;
+		auto column = level->getColumn(plainArchetypeIndex, "MyPlainTestComponent");
+		REQUIRE(column.has_value());
+		REQUIRE(column.value().size() == 3 * plainDataSize<MyPlainTestComponent>());
+		REQUIRE(reinterpret_cast<uintptr_t>(column.value().data()) % 4096 == 0);
+
+		auto loadedWorld = std::make_shared<World>();
+		loadedWorld->registerComponentCodec<MyPlainTestComponent>("MyPlainTestComponent");
+		auto loadedEntities = loadedWorld->load(*level);
+		REQUIRE(loadedEntities.has_value());
+		REQUIRE(loadedEntities.value().size() == 3);
+		for (int i = 0; i < 3; ++i) {
+			auto component = WorldFriendAccessor::getComponent<MyPlainTestComponent>(loadedWorld, loadedEntities.value()[i]);
+			REQUIRE(component.value()->id == i);
+		}
+	}
+
+	SECTION("Save level with a component without plain codec - Saving fails") {
+		world->registerComponentCodec<MyNamedTestComponent>(
+				"MyNamedTestComponent",
+				[](const MyNamedTestComponent &, std::ostream &) {},
+				[](std::istream &, MyNamedTestComponent &) {});
+		world->addComponent<MyNamedTestComponent>(world->createNewEntity().value());
+		std::stringstream stream;
+		REQUIRE_FALSE(world->saveLevel(stream));
+	}
+
+	SECTION("Map invalid file - Opening fails") {
+		{
+			auto file = std::ofstream(levelPath, std::ios::binary);
+			file << "not a level";
+		}
+		REQUIRE_FALSE(MappedLevel::open(levelPath).has_value());
+	}
+
+	std::filesystem::remove(levelPath);
+}
+
+TEST_CASE("World - Prefabs") {
+	auto world = std::make_shared<World>();
+	auto prefab = world->createPrefab();
+
+	auto testComponent = MyTestComponent();
+	testComponent.myTestValue = 42;
+	REQUIRE(world->setPrefabComponent(prefab, testComponent));
+	auto plainComponent = MyPlainTestComponent();
+	plainComponent.id = 3;
+	REQUIRE(world->setPrefabComponent(prefab, plainComponent));
+
+	SECTION("Instantiate prefab - All entities get their own copy of the prefab values") {
+		REQUIRE(world->registerSystem<MyTestSystem>({typeid(MyTestComponent)}));
+		auto entities = world->instantiate(prefab, 100);
+		REQUIRE(entities.has_value());
+		REQUIRE(entities.value().size() == 100);
+
+		for (auto entity: entities.value()) {
+			REQUIRE(WorldFriendAccessor::getComponent<MyTestComponent>(world, entity).value()->myTestValue == 42);
+			REQUIRE(WorldFriendAccessor::getComponent<MyPlainTestComponent>(world, entity).value()->id == 3);
+			REQUIRE(WorldFriendAccessor::doesSystemReferesToEntity(world, entity));
+		}
+
+		WorldFriendAccessor::getComponent<MyTestComponent>(world, entities.value()[0]).value()->myTestValue = 1;
+		REQUIRE(WorldFriendAccessor::getComponent<MyTestComponent>(world, entities.value()[1]).value()->myTestValue == 42);
+	}
+
+	SECTION("Instantiate after changing a prefab value - New entities use the new value") {
+		auto firstEntities = world->instantiate(prefab, 2).value();
+		testComponent.myTestValue = 7;
+		REQUIRE(world->setPrefabComponent(prefab, testComponent));
+		auto secondEntities = world->instantiate(prefab, 2).value();
+
+		REQUIRE(WorldFriendAccessor::getComponent<MyTestComponent>(world, firstEntities[0]).value()->myTestValue == 42);
+		REQUIRE(WorldFriendAccessor::getComponent<MyTestComponent>(world, secondEntities[0]).value()->myTestValue == 7);
+		REQUIRE(WorldFriendAccessor::hasEntityExpectedValues(world, secondEntities[1], true, Signature(3), 3));
+	}
+
+	SECTION("Instantiate invalid prefab - Nothing gets created") {
+		REQUIRE_FALSE(world->instantiate(prefab + 1, 10).has_value());
+		REQUIRE(WorldFriendAccessor::getEntityCount(world) == 0);
+	}
+}
+
+TEST_CASE("World - Statistics") {
+	auto world = std::make_shared<World>();
+	world->registerComponentCodec<MyPlainTestComponent>("MyPlainTestComponent");
+	auto entities = std::vector<Entity>();
+	for (int i = 0; i < 4; ++i) {
+		auto entity = world->createNewEntity().value();
+		world->addComponent<MyPlainTestComponent>(entity);
+		entities.push_back(entity);
+	}
+	world->addComponent<MyTestComponent>(entities[0]);
+	world->removeEntity(entities[3]);
+	REQUIRE(world->registerSystem<MyTestSystem>({typeid(MyTestComponent)}));
+	world->tick();
+
+	auto stats = world->stats();
+
+	SECTION("Collect statistics - Entity counts match the world") {
+		REQUIRE(stats.entityCount == 3);
+		REQUIRE(stats.deadEntityCount == 1);
+	}
+
+	SECTION("Collect statistics - Archetypes report rows, vacant rows and memory") {
+		REQUIRE(stats.archetypes.size() == 3);
+		for (const auto &archetypeStats: stats.archetypes) {
+			if (archetypeStats.signature != Signature(1)) continue;
+			REQUIRE(archetypeStats.componentTypes == std::vector<std::string>{"MyPlainTestComponent"});
+			REQUIRE(archetypeStats.rowCount == 4);
+			REQUIRE(archetypeStats.entityCount == 2);
+			REQUIRE(archetypeStats.rowCapacity >= 4);
+			REQUIRE(archetypeStats.bytes >= 2 * sizeof(MyPlainTestComponent));
+		}
+		REQUIRE(stats.componentBytes > 0);
+	}
+
+	SECTION("Collect statistics - Systems report their entities and update duration") {
+		REQUIRE(stats.systems.size() == 1);
+		REQUIRE(stats.systems[0].linkedEntityCount == 1);
+		REQUIRE(stats.systems[0].lastUpdateDuration.count() > 0);
+	}
+}
+
+TEST_CASE("World - Profiling") {
+	auto world = std::make_shared<World>();
+	MySpawningTestSystem::spawnWorld = world.get();
+	REQUIRE(world->registerSystem<MySpawningTestSystem>({}));
+
+	SECTION("Tick with disabled profiler - No samples are recorded") {
+		world->tick();
+		REQUIRE(world->getProfiler().getSamples().empty());
+	}
+
+	SECTION("Tick with enabled profiler - Every system update is recorded with its structural changes") {
+		world->getProfiler().setEnabled(true);
+		world->tick();
+		world->tick();
+
+		auto samples = world->getProfiler().getSamples();
+		REQUIRE(samples.size() == 2);
+		REQUIRE(samples[0].frame + 1 == samples[1].frame);
+		REQUIRE(std::string(samples[0].systemName) == typeid(MySpawningTestSystem).name());
+		REQUIRE(samples[0].structuralChanges == 1);
+
+		std::stringstream trace;
+		world->getProfiler().exportChromeTrace(trace);
+		REQUIRE(trace.str().starts_with("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[{"));
+		REQUIRE(trace.str().find("\"structuralChanges\":1") != std::string::npos);
+		REQUIRE(trace.str().ends_with("}]}"));
+	}
+}
+
+TEST_CASE("World - System groups") {
+	using namespace std::chrono_literals;
+	auto world = std::make_shared<World>();
+	MyCountingTestSystem::updateCount = 0;
+	MySecondCountingTestSystem::updateCount = 0;
+
+	SECTION("Tick a fixed step group - System runs once per accumulated step") {
+		auto fixedGroup = world->createSystemGroup(10ms);
+		REQUIRE(world->registerSystem<MyCountingTestSystem>({}, fixedGroup));
+		REQUIRE(world->registerSystem<MySecondCountingTestSystem>({}));
+
+		world->tick(5ms);
+		REQUIRE(MyCountingTestSystem::updateCount == 0);
+		REQUIRE(MySecondCountingTestSystem::updateCount == 1);
+		REQUIRE(world->getInterpolationAlpha(fixedGroup).value() == 0.5);
+
+		world->tick(25ms);
+		REQUIRE(MyCountingTestSystem::updateCount == 3);
+		REQUIRE(MyCountingTestSystem::lastDeltaTime == 10ms);
+		REQUIRE(MySecondCountingTestSystem::updateCount == 2);
+		REQUIRE(world->getInterpolationAlpha(fixedGroup).value() == 0.0);
+	}
+
+	SECTION("Tick far behind a fixed step group - Catch-up is limited and the backlog is dropped") {
+		auto fixedGroup = world->createSystemGroup(10ms, 2);
+		REQUIRE(world->registerSystem<MyCountingTestSystem>({}, fixedGroup));
+
+		world->tick(1005ms);
+		REQUIRE(MyCountingTestSystem::updateCount == 2);
+		REQUIRE(world->getInterpolationAlpha(fixedGroup).value() == 0.5);
+	}
+
+	SECTION("Register system in unknown group - Registration fails") {
+		REQUIRE_FALSE(world->registerSystem<MyCountingTestSystem>({}, 3));
+		REQUIRE_FALSE(world->getInterpolationAlpha(DEFAULT_SYSTEM_GROUP).has_value());
+	}
+}
+
+TEST_CASE("World - Events") {
+	using namespace std::chrono_literals;
+	auto world = std::make_shared<World>();
+	MyDamageReceivingTestSystem::receivedDamage = 0;
+	REQUIRE(world->registerSystem<MyDamageSendingTestSystem>({}));
+	REQUIRE(world->registerSystem<MyDamageReceivingTestSystem>({}));
+
+	SECTION("Send events during a tick - Events are delivered in the next tick") {
+		world->tick(1ms);
+		REQUIRE(MyDamageReceivingTestSystem::receivedDamage == 0);
+		REQUIRE(world->readEvents<MyTestDamageEvent>().size() == 1);
+
+		world->tick(1ms);
+		REQUIRE(MyDamageReceivingTestSystem::receivedDamage == 5);
+	}
+
+	SECTION("Send events from outside the systems - Events are delivered after the tick") {
+		world->sendEvent(MyTestDamageEvent{2, 10});
+		world->tick(1ms);
+		world->tick(1ms);
+		REQUIRE(MyDamageReceivingTestSystem::receivedDamage == 15);
+	}
+
+	SECTION("Send events in two worlds from the same thread - Every world keeps its own channel") {
+		auto otherWorld = std::make_shared<World>();
+		otherWorld->sendEvent(MyTestDamageEvent{2, 10});
+		otherWorld->tick(1ms);
+		world->tick(1ms);
+		REQUIRE(otherWorld->readEvents<MyTestDamageEvent>().size() == 1);
+		REQUIRE(world->readEvents<MyTestDamageEvent>().size() == 1);
+		REQUIRE(world->readEvents<MyTestDamageEvent>()[0].damage == 5);
+	}
+}
+
+TEST_CASE("World - Observers") {
+	auto world = std::make_shared<World>();
+	auto addCalls = std::vector<std::vector<Entity>>();
+	auto removeCalls = std::vector<std::vector<Entity>>();
+	world->onAdd<MyPlainTestComponent>([&addCalls](std::span<const Entity> entities) {
+		addCalls.emplace_back(entities.begin(), entities.end());
+	});
+	world->onRemove<MyPlainTestComponent>([&removeCalls, &world](std::span<const Entity> entities) {
+		REQUIRE(world->getComponent<MyPlainTestComponent>(entities[0]).has_value());
+		removeCalls.emplace_back(entities.begin(), entities.end());
+	});
+
+	SECTION("Add and remove a component - Observers are called once for the entity") {
+		auto entity = world->createNewEntity().value();
+		world->addComponent<MyPlainTestComponent>(entity);
+		world->addComponent<MyTestComponent>(entity);
+		REQUIRE(addCalls.size() == 1);
+		REQUIRE(addCalls[0] == std::vector<Entity>{entity});
+
+		world->removeComponent<MyTestComponent>(entity);
+		REQUIRE(removeCalls.empty());
+		world->removeComponent<MyPlainTestComponent>(entity);
+		world->removeComponent<MyPlainTestComponent>(entity);
+		REQUIRE(removeCalls.size() == 1);
+		REQUIRE(removeCalls[0] == std::vector<Entity>{entity});
+	}
+
+	SECTION("Instantiate a prefab - Observers are called once for all entities") {
+		auto prefab = world->createPrefab();
+		world->setPrefabComponent(prefab, MyPlainTestComponent());
+		auto entities = world->instantiate(prefab, 1000).value();
+		REQUIRE(addCalls.size() == 1);
+		REQUIRE(addCalls[0] == entities);
+	}
+
+	SECTION("Remove an entity - Remove observers are called for its components") {
+		auto entity = world->createNewEntity().value();
+		world->addComponent<MyPlainTestComponent>(entity);
+		world->removeEntity(entity);
+		REQUIRE(removeCalls.size() == 1);
+		REQUIRE(removeCalls[0] == std::vector<Entity>{entity});
+	}
+}
+
+TEST_CASE("World - Reserve entities") {
+	using namespace std::chrono_literals;
+	auto world = std::make_shared<World>();
+
+	SECTION("Reserve entities from worker threads - Entities exist after the next tick") {
+		auto threads = std::vector<std::thread>();
+		for (int threadIndex = 0; threadIndex < 4; ++threadIndex) {
+			threads.emplace_back([&world]() {
+				for (int i = 0; i < 100; ++i) {
+					world->reserveEntity();
+				}
+			});
+		}
+		for (auto &thread: threads) {
+			thread.join();
+		}
+		REQUIRE(WorldFriendAccessor::getEntityCount(world) == 0);
+
+		world->tick(1ms);
+		REQUIRE(WorldFriendAccessor::getEntityCount(world) == 400);
+		REQUIRE(world->commitReservedEntities().empty());
+	}
+
+	SECTION("Commit reserved entities - Components can be added") {
+		auto entity = world->reserveEntity().value();
+		REQUIRE(world->commitReservedEntities() == std::vector<Entity>{entity});
+		world->addComponent<MyPlainTestComponent>(entity);
+		REQUIRE(world->getComponent<MyPlainTestComponent>(entity).has_value());
+	}
+
+	SECTION("Reserve capacity - Spawning the reserved amount does not grow the archetype") {
+		world->reserve<MyPlainTestComponent, MyTestComponent>(100);
+		auto findArchetypeStats = [&world]() {
+			for (const auto &archetypeStats: world->stats().archetypes) {
+				if (archetypeStats.componentTypes.size() == 2) return archetypeStats;
+			}
+			return ArchetypeStats();
+		};
+		auto reservedStats = findArchetypeStats();
+		REQUIRE(reservedStats.rowCount == 0);
+		REQUIRE(reservedStats.rowCapacity >= 100);
+
+		for (int i = 0; i < 100; ++i) {
+			auto entity = world->createNewEntity().value();
+			world->addComponent<MyPlainTestComponent>(entity);
+			world->addComponent<MyTestComponent>(entity);
+		}
+		auto spawnedStats = findArchetypeStats();
+		REQUIRE(spawnedStats.rowCount == 100);
+		REQUIRE(spawnedStats.rowCapacity == reservedStats.rowCapacity);
+	}
+}
+
+TEST_CASE("World - Spatial index") {
+	using namespace std::chrono_literals;
+	auto world = std::make_shared<World>();
+	auto entityA = world->createNewEntity().value();
+	world->addComponent<MyPlainTestComponent>(entityA);
+	REQUIRE(world->createSpatialIndex<MyPlainTestComponent>(4.0f, [](const MyPlainTestComponent &component) {
+		return SpatialPoint{component.x, component.y, 0.0f};
+	}));
+	REQUIRE_FALSE(world->createSpatialIndex<MyPlainTestComponent>(4.0f, [](const MyPlainTestComponent &) {
+		return SpatialPoint{};
+	}));
+	auto spatialIndex = world->getSpatialIndex<MyPlainTestComponent>().value();
+
+	SECTION("Create an index - Existing and new entities are indexed") {
+		auto entityB = world->createNewEntity().value();
+		world->addComponent<MyPlainTestComponent>(entityB);
+		REQUIRE(spatialIndex->size() == 2);
+		REQUIRE(spatialIndex->queryRadius(SpatialPoint{}, 1.0f).size() == 2);
+	}
+
+	SECTION("Move an entity - The index follows after the next tick") {
+		world->getComponent<MyPlainTestComponent>(entityA).value()->x = 20.0f;
+		REQUIRE(spatialIndex->queryRadius(SpatialPoint{20.0f, 0.0f, 0.0f}, 1.0f).empty());
+		world->tick(1ms);
+		REQUIRE(spatialIndex->queryRadius(SpatialPoint{20.0f, 0.0f, 0.0f}, 1.0f) == std::vector<Entity>{entityA});
+	}
+
+	SECTION("Move entities after clearing the changed rows - Only the changed rows are read again") {
+		auto entityB = world->createNewEntity().value();
+		world->addComponent<MyPlainTestComponent>(entityB);
+		auto componentA = world->getComponent<MyPlainTestComponent>(entityA).value();
+		world->getComponent<MyPlainTestComponent>(entityB).value()->x = 20.0f;
+		world->clearChangedRows();
+		REQUIRE(spatialIndex->queryRadius(SpatialPoint{20.0f, 0.0f, 0.0f}, 1.0f) == std::vector<Entity>{entityB});
+
+		componentA->x = 20.0f;
+		world->tick(1ms);
+		REQUIRE(spatialIndex->queryRadius(SpatialPoint{20.0f, 0.0f, 0.0f}, 1.0f) == std::vector<Entity>{entityB});
+		world->getComponent<MyPlainTestComponent>(entityA);
+		world->tick(1ms);
+		REQUIRE(spatialIndex->queryRadius(SpatialPoint{20.0f, 0.0f, 0.0f}, 1.0f).size() == 2);
+	}
+
+	SECTION("Remove the component - The entity leaves the index") {
+		world->addComponent<MyTestComponent>(entityA);
+		world->removeComponent<MyPlainTestComponent>(entityA);
+		REQUIRE(spatialIndex->size() == 0);
+	}
+}
+
+TEST_CASE("World - Component alignment") {
+	auto world = std::make_shared<World>();
+	REQUIRE(getComponentAlignment<MyTestComponent>() == alignof(MyTestComponent));
+	REQUIRE(getComponentAlignment<MyCacheLineTestComponent>() == 64);
+	REQUIRE(getComponentAlignment<MyOverAlignedTestComponent>() == 32);
+
+	SECTION("Add aligned components - Instances are allocated with the component alignment") {
+		for (int i = 0; i < 16; ++i) {
+			auto entity = world->createNewEntity().value();
+			world->addComponent<MyCacheLineTestComponent>(entity);
+			world->addComponent<MyOverAlignedTestComponent>(entity);
+			auto cacheLineComponent = world->getComponent<MyCacheLineTestComponent>(entity).value();
+			auto overAlignedComponent = world->getComponent<MyOverAlignedTestComponent>(entity).value();
+			REQUIRE(reinterpret_cast<uintptr_t>(cacheLineComponent.get()) % 64 == 0);
+			REQUIRE(reinterpret_cast<uintptr_t>(overAlignedComponent.get()) % 32 == 0);
+		}
+	}
+
+	SECTION("Instantiate a prefab - Copied instances keep the component alignment") {
+		auto prefab = world->createPrefab();
+		MyCacheLineTestComponent prefabComponent;
+		prefabComponent.value = 3.0f;
+		world->setPrefabComponent(prefab, prefabComponent);
+		auto entities = world->instantiate(prefab, 16).value();
+		for (const Entity entity: entities) {
+			auto component = world->getComponent<MyCacheLineTestComponent>(entity).value();
+			REQUIRE(reinterpret_cast<uintptr_t>(component.get()) % 64 == 0);
+			REQUIRE(component->value == 3.0f);
+		}
+	}
+}
+
+TEST_CASE("World - SoA chunks") {
+	auto world = std::make_shared<World>();
+	auto entities = std::vector<Entity>();
+	for (int i = 0; i < 21; ++i) {
+		auto entity = world->createNewEntity().value();
+		world->addComponent<MyPositionTestComponent>(entity);
+		world->addComponent<MyVelocityTestComponent>(entity);
+		auto velocity = world->getComponent<MyVelocityTestComponent>(entity).value();
+		velocity->x = static_cast<float>(i);
+		velocity->z = -1.0f;
+		entities.push_back(entity);
+	}
+	auto positionOnlyEntity = world->createNewEntity().value();
+	world->addComponent<MyPositionTestComponent>(positionOnlyEntity);
+
+	SECTION("Integrate velocities in batches - All matching entities are updated") {
+		world->clearChangedRows();
+		size_t chunkCount = 0;
+		world->forEachSoAChunk<MyPositionTestComponent, const MyVelocityTestComponent>(
+				[&chunkCount](SoAColumn<MyPositionTestComponent> &positions,
+				              const SoAColumn<MyVelocityTestComponent> &velocities) {
+					REQUIRE(positions.getRowCount() == velocities.getRowCount());
+					REQUIRE(positions.getBatchCount() * SOA_BATCH_WIDTH >= positions.getRowCount());
+					for (size_t field = 0; field < 3; ++field) {
+						float *position = positions.getField(field);
+						const float *velocity = velocities.getField(field);
+						REQUIRE(reinterpret_cast<uintptr_t>(position) % (SOA_BATCH_WIDTH * sizeof(float)) == 0);
+						for (size_t batch = 0; batch < positions.getBatchCount(); ++batch) {
+							for (size_t lane = 0; lane < SOA_BATCH_WIDTH; ++lane) {
+								size_t row = batch * SOA_BATCH_WIDTH + lane;
+								position[row] += velocity[row] * 0.5f;
+							}
+						}
+					}
+					chunkCount++;
+				});
+
+		REQUIRE(chunkCount == 1);
+		// Only the written column is scattered back and marked as changed.
+		REQUIRE(WorldFriendAccessor::getChangedRowCount<MyPositionTestComponent>(world) == 21);
+		REQUIRE(WorldFriendAccessor::getChangedRowCount<MyVelocityTestComponent>(world) == 0);
+		for (int i = 0; i < 21; ++i) {
+			auto position = world->getComponent<MyPositionTestComponent>(entities[i]).value();
+			REQUIRE(position->x == static_cast<float>(i) * 0.5f);
+			REQUIRE(position->y == 0.0f);
+			REQUIRE(position->z == -0.5f);
+		}
+		REQUIRE(world->getComponent<MyPositionTestComponent>(positionOnlyEntity).value()->x == 0.0f);
+	}
+
+	SECTION("Skip disabled rows - Rows disabled in any column are neither read nor written") {
+		world->getComponent<MyPositionTestComponent>(entities[3]).value()->x = 7.0f;
+		REQUIRE(world->setComponentEnabled<MyPositionTestComponent>(entities[3], false));
+		REQUIRE(world->setComponentEnabled<MyVelocityTestComponent>(entities[4], false));
+		world->clearChangedRows();
+
+		world->forEachSoAChunk<MyPositionTestComponent, const MyVelocityTestComponent>(
+				[](SoAColumn<MyPositionTestComponent> &positions, const SoAColumn<MyVelocityTestComponent> &velocities) {
+					REQUIRE(positions.getField(0)[3] == 0.0f);
+					REQUIRE(velocities.getField(0)[4] == 0.0f);
+					for (size_t row = 0; row < positions.getRowCount(); ++row) {
+						positions.getField(0)[row] = velocities.getField(0)[row] + 100.0f;
+					}
+				});
+
+		REQUIRE(WorldFriendAccessor::getChangedRowCount<MyPositionTestComponent>(world) == 19);
+		REQUIRE(world->getComponent<MyPositionTestComponent>(entities[3]).value()->x == 7.0f);
+		REQUIRE(world->getComponent<MyPositionTestComponent>(entities[4]).value()->x == 0.0f);
+		REQUIRE(world->getComponent<MyPositionTestComponent>(entities[5]).value()->x == 105.0f);
+	}
+}
+
+TEST_CASE("World - Simulation runner") {
+	using namespace std::chrono_literals;
+	MyThreadSafeCountingTestSystem::updateCount = 0;
+	auto runner = SimulationRunner(1ms);
+	for (int i = 0; i < 3; ++i) {
+		auto world = std::make_shared<World>();
+		REQUIRE(world->registerSystem<MyThreadSafeCountingTestSystem>({}));
+		REQUIRE(runner.addWorld(world) == std::make_optional<size_t>(i));
+	}
+
+	SECTION("Run with a tick limit - Every world ticks on its own thread until the limit") {
+		REQUIRE(runner.start(5));
+		REQUIRE_FALSE(runner.start(5));
+		REQUIRE_FALSE(runner.addWorld(std::make_shared<World>()).has_value());
+		runner.wait();
+
+		REQUIRE(MyThreadSafeCountingTestSystem::updateCount == 15);
+		auto statistics = runner.getStatistics();
+		REQUIRE(statistics.size() == 3);
+		for (const auto &worldStatistics: statistics) {
+			REQUIRE(worldStatistics.tickCount == 5);
+			REQUIRE(worldStatistics.minTickDuration <= worldStatistics.getAverageTickDuration());
+			REQUIRE(worldStatistics.getAverageTickDuration() <= worldStatistics.maxTickDuration);
+		}
+	}
+
+	SECTION("Run without a tick limit - Worlds tick until stopped") {
+		REQUIRE(runner.start());
+		std::this_thread::sleep_for(20ms);
+		runner.stop();
+		REQUIRE_FALSE(runner.isRunning());
+		REQUIRE(runner.getStatistics()[0].tickCount > 0);
+	}
+}
+
+TEST_CASE("World - Shared component registry") {
+	auto componentRegistry = std::make_shared<ComponentRegistry>();
+	auto sourceWorld = std::make_shared<World>(componentRegistry);
+	auto targetWorld = std::make_shared<World>(componentRegistry);
+	REQUIRE(targetWorld->getComponentRegistry() == componentRegistry);
+
+	// Register the components in a different order, the shared registry still assigns the same bits.
+	auto targetEntity = targetWorld->createNewEntity().value();
+	targetWorld->addComponent<MyTestComponent>(targetEntity);
+	auto sourceEntities = std::vector<Entity>();
+	for (int i = 0; i < 6; ++i) {
+		auto entity = sourceWorld->createNewEntity().value();
+		sourceWorld->addComponent<MyPlainTestComponent>(entity);
+		sourceWorld->getComponent<MyPlainTestComponent>(entity).value()->id = i;
+		if (i % 2 == 0) sourceWorld->addComponent<MyTestComponent>(entity);
+		sourceEntities.push_back(entity);
+	}
+	REQUIRE(componentRegistry->getComponentCount() == 2);
+	REQUIRE(componentRegistry->getSignature(typeid(MyTestComponent)) == Signature(1));
+
+	SECTION("Move entities - Components are handed over and the source entities are removed") {
+		auto removedCount = 0;
+		sourceWorld->onRemove<MyPlainTestComponent>([&removedCount](std::span<const Entity> entities) {
+			removedCount += static_cast<int>(entities.size());
+		});
+		auto movedComponent = sourceWorld->getComponent<MyPlainTestComponent>(sourceEntities[1]).value();
+		auto entitiesToMove = std::vector<Entity>{sourceEntities[1], sourceEntities[2], sourceEntities[4]};
+
+		auto movedEntities = World::moveEntities(*sourceWorld, *targetWorld, entitiesToMove).value();
+		REQUIRE(movedEntities.size() == 3);
+		REQUIRE(removedCount == 3);
+		REQUIRE(targetWorld->getComponent<MyPlainTestComponent>(movedEntities[0]).value() == movedComponent);
+		REQUIRE(targetWorld->getComponent<MyPlainTestComponent>(movedEntities[1]).value()->id == 2);
+		REQUIRE(targetWorld->getComponent<MyTestComponent>(movedEntities[1]).has_value());
+		REQUIRE_FALSE(targetWorld->getComponent<MyTestComponent>(movedEntities[0]).has_value());
+		REQUIRE(targetWorld->getComponent<MyPlainTestComponent>(movedEntities[2]).value()->id == 4);
+
+		REQUIRE(WorldFriendAccessor::getEntityCount(sourceWorld) == 3);
+		REQUIRE_FALSE(sourceWorld->getComponent<MyPlainTestComponent>(sourceEntities[1]).has_value());
+		REQUIRE(sourceWorld->getComponent<MyPlainTestComponent>(sourceEntities[3]).value()->id == 3);
+		REQUIRE(sourceWorld->getComponent<MyPlainTestComponent>(sourceEntities[5]).value()->id == 5);
+	}
+
+	SECTION("Move neighbouring rows - Ranges are handed over at once and keep their state") {
+		sourceWorld->setComponentEnabled<MyPlainTestComponent>(sourceEntities[3], false);
+		auto entitiesToMove = std::vector<Entity>{sourceEntities[5], sourceEntities[1], sourceEntities[3]};
+
+		auto movedEntities = World::moveEntities(*sourceWorld, *targetWorld, entitiesToMove).value();
+		REQUIRE(movedEntities.size() == 3);
+		REQUIRE(targetWorld->getComponent<MyPlainTestComponent>(movedEntities[0]).value()->id == 5);
+		REQUIRE(targetWorld->getComponent<MyPlainTestComponent>(movedEntities[1]).value()->id == 1);
+		REQUIRE(targetWorld->getComponent<MyPlainTestComponent>(movedEntities[2]).value()->id == 3);
+		REQUIRE(targetWorld->isComponentEnabled<MyPlainTestComponent>(movedEntities[0]).value());
+		REQUIRE_FALSE(targetWorld->isComponentEnabled<MyPlainTestComponent>(movedEntities[2]).value());
+		REQUIRE(sourceWorld->getComponent<MyPlainTestComponent>(sourceEntities[4]).value()->id == 4);
+		REQUIRE(sourceWorld->isComponentEnabled<MyPlainTestComponent>(sourceEntities[4]).value());
+	}
+
+	SECTION("Move invalid entities - Nothing is moved") {
+		auto entitiesToMove = std::vector<Entity>{sourceEntities[0], sourceEntities[0]};
+		REQUIRE_FALSE(World::moveEntities(*sourceWorld, *targetWorld, entitiesToMove).has_value());
+		REQUIRE_FALSE(World::moveEntities(*sourceWorld, *sourceWorld, sourceEntities).has_value());
+		REQUIRE(WorldFriendAccessor::getEntityCount(sourceWorld) == 6);
+	}
+
+	SECTION("Move more entities than the target can create - Nothing is moved") {
+		auto removedCount = 0;
+		sourceWorld->onRemove<MyPlainTestComponent>([&removedCount](std::span<const Entity> entities) {
+			removedCount += static_cast<int>(entities.size());
+		});
+		WorldFriendAccessor::setEntityCount(targetWorld, std::numeric_limits<uint>::max() - 1);
+
+		auto entitiesToMove = std::vector<Entity>{sourceEntities[1], sourceEntities[2]};
+		REQUIRE_FALSE(World::moveEntities(*sourceWorld, *targetWorld, entitiesToMove).has_value());
+		REQUIRE(removedCount == 0);
+		REQUIRE(WorldFriendAccessor::getEntityCount(sourceWorld) == 6);
+		REQUIRE(sourceWorld->getComponent<MyPlainTestComponent>(sourceEntities[1]).value()->id == 1);
+		REQUIRE(sourceWorld->getComponent<MyTestComponent>(sourceEntities[2]).has_value());
+	}
+}
+
+class MyMaterialTestComponent : public Component {
+	public:
+		int textureId = 0;
+
+		bool operator==(const MyMaterialTestComponent &other) const {
+			return textureId == other.textureId;
+		}
+};
+
+TEST_CASE("World - Shared components") {
+	auto world = std::make_shared<World>();
+	auto entities = std::vector<Entity>();
+	for (int i = 0; i < 6; ++i) {
+		auto entity = world->createNewEntity().value();
+		MyMaterialTestComponent material;
+		material.textureId = i % 2;
+		REQUIRE(world->setSharedComponent(entity, material));
+		entities.push_back(entity);
+	}
+
+	auto collectGroups = [&world]() {
+		auto groups = std::map<int, std::vector<Entity>>();
+		world->forEachSharedComponentGroup<MyMaterialTestComponent>(
+				[&groups](const MyMaterialTestComponent &material, std::span<const Entity> groupEntities) {
+					auto sortedEntities = std::vector<Entity>(groupEntities.begin(), groupEntities.end());
+					std::sort(sortedEntities.begin(), sortedEntities.end());
+					groups[material.textureId] = sortedEntities;
+				});
+		return groups;
+	};
+
+	SECTION("Assign equal values - Entities share a single instance and are grouped by value") {
+		REQUIRE(world->getSharedComponent<MyMaterialTestComponent>(entities[0]).value() ==
+		        world->getSharedComponent<MyMaterialTestComponent>(entities[2]).value());
+		auto groups = collectGroups();
+		REQUIRE(groups.size() == 2);
+		REQUIRE(groups[0] == std::vector<Entity>{entities[0], entities[2], entities[4]});
+		REQUIRE(groups[1] == std::vector<Entity>{entities[1], entities[3], entities[5]});
+	}
+
+	SECTION("Change and remove values - Entities switch groups and empty groups disappear") {
+		MyMaterialTestComponent material;
+		material.textureId = 7;
+		world->setSharedComponent(entities[1], material);
+		world->removeSharedComponent<MyMaterialTestComponent>(entities[3]);
+		world->removeEntity(entities[5]);
+
+		auto groups = collectGroups();
+		REQUIRE(groups.size() == 2);
+		REQUIRE(groups[7] == std::vector<Entity>{entities[1]});
+		REQUIRE_FALSE(world->getSharedComponent<MyMaterialTestComponent>(entities[3]).has_value());
+
+		world->removeSharedComponent<MyMaterialTestComponent>(entities[1]);
+		REQUIRE(collectGroups().size() == 1);
+	}
+
+	SECTION("Move entities to another world - Shared values move along") {
+		auto targetWorld = std::make_shared<World>(world->getComponentRegistry());
+		auto movedEntities = World::moveEntities(*world, *targetWorld, std::vector<Entity>{entities[0], entities[1]}).value();
+		REQUIRE(targetWorld->getSharedComponent<MyMaterialTestComponent>(movedEntities[0]).value()->textureId == 0);
+		REQUIRE(targetWorld->getSharedComponent<MyMaterialTestComponent>(movedEntities[1]).value()->textureId == 1);
+		REQUIRE(collectGroups()[0] == std::vector<Entity>{entities[2], entities[4]});
+	}
+}
+
+class MyTeamTestComponent : public Component {
+	public:
+		int teamId = 0;
+
+		bool operator==(const MyTeamTestComponent &other) const {
+			return teamId == other.teamId;
+		}
+};
+
+// Few distinct hashes, so values with equal hashes have to be told apart by comparing them.
+template<>
+struct std::hash<MyTeamTestComponent> {
+	size_t operator()(const MyTeamTestComponent &team) const {
+		return static_cast<size_t>(team.teamId % 4);
+	}
+};
+
+TEST_CASE("World - Hashable shared components") {
+	auto world = std::make_shared<World>();
+	auto entities = std::vector<Entity>();
+	for (int i = 0; i < 100; ++i) {
+		auto entity = world->createNewEntity().value();
+		MyTeamTestComponent team;
+		team.teamId = i % 20;
+		REQUIRE(world->setSharedComponent(entity, team));
+		entities.push_back(entity);
+	}
+
+	auto countGroups = [&world](size_t thirdTeamSize) {
+		size_t groupCount = 0;
+		world->forEachSharedComponentGroup<MyTeamTestComponent>(
+				[&groupCount, thirdTeamSize](const MyTeamTestComponent &team, std::span<const Entity> groupEntities) {
+					REQUIRE(groupEntities.size() == (team.teamId == 3 ? thirdTeamSize : 5));
+					groupCount++;
+				});
+		return groupCount;
+	};
+
+	SECTION("Assign values with equal hashes - Every value keeps its own group") {
+		REQUIRE(countGroups(5) == 20);
+		REQUIRE(world->getSharedComponent<MyTeamTestComponent>(entities[4]).value() ==
+		        world->getSharedComponent<MyTeamTestComponent>(entities[24]).value());
+		REQUIRE(world->getSharedComponent<MyTeamTestComponent>(entities[4]).value() !=
+		        world->getSharedComponent<MyTeamTestComponent>(entities[8]).value());
+	}
+
+	SECTION("Empty a group and add a new value - The freed group is found by its new value") {
+		for (int i = 3; i < 100; i += 20) {
+			world->removeSharedComponent<MyTeamTestComponent>(entities[i]);
+		}
+		MyTeamTestComponent team;
+		team.teamId = 3;
+		REQUIRE(world->setSharedComponent(entities[3], team));
+		REQUIRE(world->setSharedComponent(entities[23], team));
+		REQUIRE(world->setSharedComponent(entities[43], team));
+		REQUIRE(world->setSharedComponent(entities[63], team));
+		REQUIRE(countGroups(4) == 20);
+		REQUIRE(world->getSharedComponent<MyTeamTestComponent>(entities[3]).value() ==
+		        world->getSharedComponent<MyTeamTestComponent>(entities[63]).value());
+	}
+}
+
+TEST_CASE("World - Enableable components") {
+	auto world = std::make_shared<World>();
+	auto entities = std::vector<Entity>();
+	for (int i = 0; i < 130; ++i) {
+		auto entity = world->createNewEntity().value();
+		world->addComponent<MyPlainTestComponent>(entity);
+		world->getComponent<MyPlainTestComponent>(entity).value()->id = i;
+		entities.push_back(entity);
+	}
+	auto collectEnabledIds = [&world]() {
+		auto ids = std::vector<int>();
+		world->forEachEnabled<MyPlainTestComponent>([&ids](MyPlainTestComponent &component) {
+			ids.push_back(component.id);
+		});
+		return ids;
+	};
+
+	SECTION("Disable components - Queries skip them and no archetype migration happens") {
+		auto rowCount = WorldFriendAccessor::getArchetypeRowCount(world, Signature(1));
+		for (int i = 0; i < 130; ++i) {
+			if (i % 3 != 0) REQUIRE(world->setComponentEnabled<MyPlainTestComponent>(entities[i], false));
+		}
+		REQUIRE(WorldFriendAccessor::getArchetypeRowCount(world, Signature(1)) == rowCount);
+		REQUIRE(world->isComponentEnabled<MyPlainTestComponent>(entities[1]) == std::make_optional(false));
+		REQUIRE(world->isComponentEnabled<MyPlainTestComponent>(entities[3]) == std::make_optional(true));
+		REQUIRE_FALSE(world->isComponentEnabled<MyTestComponent>(entities[3]).has_value());
+
+		auto ids = collectEnabledIds();
+		REQUIRE(ids.size() == 44);
+		for (const int id: ids) {
+			REQUIRE(id % 3 == 0);
+		}
+
+		world->setComponentEnabled<MyPlainTestComponent>(entities[1], true);
+		REQUIRE(collectEnabledIds().size() == 45);
+	}
+
+	SECTION("Migrate and remove entities - The enabled state stays with its component") {
+		world->setComponentEnabled<MyPlainTestComponent>(entities[70], false);
+		world->setComponentEnabled<MyPlainTestComponent>(entities[100], false);
+		world->addComponent<MyTestComponent>(entities[70]);
+		world->removeEntity(entities[0]);
+		REQUIRE(world->isComponentEnabled<MyPlainTestComponent>(entities[70]) == std::make_optional(false));
+		REQUIRE(world->isComponentEnabled<MyPlainTestComponent>(entities[100]) == std::make_optional(false));
+		REQUIRE(world->isComponentEnabled<MyPlainTestComponent>(entities[99]) == std::make_optional(true));
+
+		world->defragment();
+		REQUIRE(world->isComponentEnabled<MyPlainTestComponent>(entities[100]) == std::make_optional(false));
+		REQUIRE(collectEnabledIds().size() == 127);
+	}
+}
+
+class MyWaypointsTestComponent : public DynamicBuffer<std::string, 4> {
+};
+
+TEST_CASE("World - Dynamic buffers") {
+	auto world = std::make_shared<World>();
+	auto entity = world->createNewEntity().value();
+	world->addComponent<MyWaypointsTestComponent>(entity);
+	auto waypoints = world->getComponent<MyWaypointsTestComponent>(entity).value();
+
+	SECTION("Small buffers - Elements are stored inline") {
+		waypoints->push_back("a");
+		waypoints->emplace_back("b");
+		REQUIRE(waypoints->size() == 2);
+		REQUIRE(waypoints->isInline());
+		REQUIRE((*waypoints)[1] == "b");
+		waypoints->pop_back();
+		REQUIRE(waypoints->size() == 1);
+	}
+
+	SECTION("Grow past the inline capacity - Elements spill into a pooled block") {
+		for (int i = 0; i < 10; ++i) {
+			waypoints->push_back(std::to_string(i));
+		}
+		REQUIRE_FALSE(waypoints->isInline());
+		REQUIRE(waypoints->capacity() == 16);
+		REQUIRE(std::vector<std::string>(waypoints->begin(), waypoints->end()) ==
+		        std::vector<std::string>{"0", "1", "2", "3", "4", "5", "6", "7", "8", "9"});
+
+		// Elements of the buffer itself can be appended while it grows.
+		for (int i = 0; i < 6; ++i) {
+			waypoints->push_back((*waypoints)[0]);
+		}
+		waypoints->push_back((*waypoints)[0]);
+		REQUIRE(waypoints->size() == 17);
+		REQUIRE((*waypoints)[16] == "0");
+
+		// The block of a removed entity is reused by the next buffer that spills.
+		DynamicBufferPool<std::string>::releasePooledBlocks();
+		waypoints.reset();
+		world->removeEntity(entity);
+		REQUIRE(DynamicBufferPool<std::string>::getPooledBlockCount() == 1);
+		auto buffer = DynamicBuffer<std::string, 1>();
+		buffer.reserve(20);
+		REQUIRE(DynamicBufferPool<std::string>::getPooledBlockCount() == 0);
+	}
+
+	SECTION("Instantiate a prefab - Every entity gets its own copy") {
+		auto prefab = world->createPrefab();
+		world->setPrefabComponent(prefab, MyWaypointsTestComponent());
+		auto entities = world->instantiate(prefab, 2).value();
+		auto firstWaypoints = world->getComponent<MyWaypointsTestComponent>(entities[0]).value();
+		for (int i = 0; i < 8; ++i) {
+			firstWaypoints->push_back(std::to_string(i));
+		}
+		REQUIRE(firstWaypoints->size() == 8);
+		REQUIRE(world->getComponent<MyWaypointsTestComponent>(entities[1]).value()->empty());
+
+		auto copiedWaypoints = *firstWaypoints;
+		REQUIRE(copiedWaypoints.size() == 8);
+		REQUIRE(copiedWaypoints[7] == "7");
+		auto movedWaypoints = std::move(copiedWaypoints);
+		REQUIRE(movedWaypoints.size() == 8);
+		REQUIRE(copiedWaypoints.empty());
+	}
+}
+
+TEST_CASE("World - Sort rows") {
+	auto world = std::make_shared<World>();
+	auto entities = std::vector<Entity>();
+	auto positions = std::vector<std::shared_ptr<MyPositionTestComponent>>();
+	for (int i = 0; i < 6; ++i) {
+		auto entity = world->createNewEntity().value();
+		world->addComponent<MyPositionTestComponent>(entity);
+		auto position = world->getComponent<MyPositionTestComponent>(entity).value();
+		position->x = static_cast<float>(10 - i);
+		entities.push_back(entity);
+		positions.push_back(position);
+	}
+	world->registerSystem<MyTestSystem>({typeid(MyPositionTestComponent)});
+	world->removeEntity(entities[5]);
+	world->defragment();
+	entities.pop_back();
+	positions.pop_back();
+
+	auto collectRowValues = [&world]() {
+		auto rowValues = std::vector<float>();
+		world->forEachSoAChunk<MyPositionTestComponent>([&rowValues](SoAColumn<MyPositionTestComponent> &column) {
+			rowValues.assign(column.getField(0), column.getField(0) + column.getRowCount());
+		});
+		return rowValues;
+	};
+
+	SECTION("Sort by a key - Rows are reordered and entities keep their components") {
+		REQUIRE(collectRowValues() == std::vector<float>{10, 9, 8, 7, 6});
+		REQUIRE(world->sortRows<MyPositionTestComponent>([](const MyPositionTestComponent &position) {
+			return position.x;
+		}));
+		REQUIRE(collectRowValues() == std::vector<float>{6, 7, 8, 9, 10});
+		for (size_t i = 0; i < entities.size(); ++i) {
+			REQUIRE(world->getComponent<MyPositionTestComponent>(entities[i]).value() == positions[i]);
+		}
+		REQUIRE(WorldFriendAccessor::hasEntityExpectedValues(world, entities[4], true, Signature(1), 0));
+		REQUIRE(WorldFriendAccessor::doesSystemReferesToEntity(world, entities[4]));
+	}
+
+	SECTION("Sort by Morton code - Neighbouring cells end up in neighbouring rows") {
+		REQUIRE(computeMortonCode(SpatialPoint{0.5f, 0.5f, 0.5f}, 1.0f) < computeMortonCode(SpatialPoint{1.5f, 0.0f, 0.0f}, 1.0f));
+		REQUIRE(computeMortonCode(SpatialPoint{1.5f, 0.0f, 0.0f}, 1.0f) < computeMortonCode(SpatialPoint{0.0f, 1.5f, 0.0f}, 1.0f));
+		REQUIRE(computeMortonCode(SpatialPoint{-1.0f, 0.0f, 0.0f}, 1.0f) < computeMortonCode(SpatialPoint{0.0f, 0.0f, 0.0f}, 1.0f));
+
+		world->sortRows<MyPositionTestComponent>([](const MyPositionTestComponent &position) {
+			return computeMortonCode(SpatialPoint{position.x, position.y, position.z}, 4.0f);
+		});
+		auto rowValues = collectRowValues();
+		REQUIRE(std::is_sorted(rowValues.begin(), rowValues.end(), [](float a, float b) {
+			return computeMortonCode(SpatialPoint{a, 0.0f, 0.0f}, 4.0f) < computeMortonCode(SpatialPoint{b, 0.0f, 0.0f}, 4.0f);
+		}));
+		REQUIRE(world->getComponent<MyPositionTestComponent>(entities[0]).value()->x == 10.0f);
+	}
+}
+
+TEST_CASE("World - Snapshots") {
+	auto world = std::make_shared<World>();
+	auto entities = std::vector<Entity>();
+	for (int i = 0; i < 4; ++i) {
+		auto entity = world->createNewEntity().value();
+		world->addComponent<MyPositionTestComponent>(entity);
+		world->getComponent<MyPositionTestComponent>(entity).value()->x = static_cast<float>(i);
+		entities.push_back(entity);
+	}
+	MyMaterialTestComponent material;
+	material.textureId = 7;
+	world->setSharedComponent(entities[0], material);
+	world->registerSystem<MyTestSystem>({typeid(MyPositionTestComponent)});
+	auto snapshotRing = SnapshotRing(2);
+	snapshotRing.capture(*world, 0);
+
+	// Change values and the structure of the world after the capture.
+	world->getComponent<MyPositionTestComponent>(entities[1]).value()->x = 100.0f;
+	world->addComponent<MyPlainTestComponent>(entities[2]);
+	world->removeEntity(entities[3]);
+	material.textureId = 8;
+	world->setSharedComponent(entities[0], material);
+	auto createdEntity = world->createNewEntity().value();
+	world->addComponent<MyPositionTestComponent>(createdEntity);
+	world->defragment();
+
+	SECTION("Restore a frame - Values, entities and system links are rewound") {
+		REQUIRE(snapshotRing.restore(*world, 0));
+		for (int i = 0; i < 4; ++i) {
+			REQUIRE(world->getComponent<MyPositionTestComponent>(entities[i]).value()->x == static_cast<float>(i));
+		}
+		REQUIRE_FALSE(world->getComponent<MyPlainTestComponent>(entities[2]).has_value());
+		REQUIRE(world->getSharedComponent<MyMaterialTestComponent>(entities[0]).value()->textureId == 7);
+		REQUIRE(WorldFriendAccessor::getEntityCount(world) == 4);
+		for (auto &entity: entities) {
+			REQUIRE(WorldFriendAccessor::doesSystemReferesToEntity(world, entity));
+		}
+
+		// Running the same changes again creates the same entities as the first time.
+		world->removeEntity(entities[3]);
+		REQUIRE(world->createNewEntity().value() == createdEntity);
+	}
+
+	SECTION("Restore a frame with a spatial index - The index follows the restored entities") {
+		REQUIRE(world->createSpatialIndex<MyPositionTestComponent>(1.0f, [](const MyPositionTestComponent &position) {
+			return SpatialPoint{position.x, position.y, position.z};
+		}));
+		auto spatialIndex = world->getSpatialIndex<MyPositionTestComponent>().value();
+		REQUIRE(spatialIndex->queryRadius(SpatialPoint{3.0f, 0.0f, 0.0f}, 0.5f).empty());
+
+		REQUIRE(snapshotRing.restore(*world, 0));
+		world->refreshSpatialIndices();
+		REQUIRE(spatialIndex->size() == 4);
+		REQUIRE(spatialIndex->queryRadius(SpatialPoint{3.0f, 0.0f, 0.0f}, 0.5f) == std::vector<Entity>{entities[3]});
+		REQUIRE(spatialIndex->queryRadius(SpatialPoint{100.0f, 0.0f, 0.0f}, 0.5f).empty());
+
+		// The index reads the restored instances, not the ones replaced by the restore.
+		world->getComponent<MyPositionTestComponent>(entities[1]).value()->x = 50.0f;
+		world->refreshSpatialIndices();
+		REQUIRE(spatialIndex->queryRadius(SpatialPoint{50.0f, 0.0f, 0.0f}, 0.5f) == std::vector<Entity>{entities[1]});
+	}
+
+	SECTION("Capture more frames than the ring holds - The oldest frame is replaced") {
+		snapshotRing.capture(*world, 1);
+		REQUIRE(snapshotRing.getOldestFrame() == 0);
+		snapshotRing.capture(*world, 2);
+		REQUIRE_FALSE(snapshotRing.contains(0));
+		REQUIRE_FALSE(snapshotRing.restore(*world, 0));
+		REQUIRE(snapshotRing.getOldestFrame() == 1);
+
+		world->getComponent<MyPositionTestComponent>(entities[1]).value()->x = 5.0f;
+		REQUIRE(snapshotRing.restore(*world, 1));
+		REQUIRE(world->getComponent<MyPositionTestComponent>(entities[1]).value()->x == 100.0f);
+		REQUIRE(world->getComponent<MyPlainTestComponent>(entities[2]).has_value());
+		REQUIRE(world->getComponent<MyPositionTestComponent>(createdEntity).has_value());
+	}
+
+	SECTION("Capture into the same snapshot again - Only columns changed since the last capture are copied") {
+		auto snapshot = WorldSnapshot();
+		auto position = world->getComponent<MyPositionTestComponent>(entities[0]).value();
+		world->captureSnapshot(snapshot);
+
+		// Writes through an instance handed out before the capture are not seen, like by writeDiff.
+		position->x = 30.0f;
+		world->captureSnapshot(snapshot);
+		world->getComponent<MyPositionTestComponent>(entities[1]).value()->x = 40.0f;
+		REQUIRE(world->restoreSnapshot(snapshot));
+		REQUIRE(world->getComponent<MyPositionTestComponent>(entities[0]).value()->x == 0.0f);
+
+		world->getComponent<MyPositionTestComponent>(entities[0]).value()->x = 30.0f;
+		world->captureSnapshot(snapshot);
+		world->getComponent<MyPositionTestComponent>(entities[0]).value()->x = 0.0f;
+		REQUIRE(world->restoreSnapshot(snapshot));
+		REQUIRE(world->getComponent<MyPositionTestComponent>(entities[0]).value()->x == 30.0f);
+		REQUIRE(world->getComponent<MyPositionTestComponent>(entities[1]).value()->x == 100.0f);
+	}
+}
+
+TEST_CASE("World - Diffs") {
+	auto registerCodecs = [](World &world) {
+		world.registerComponentCodec<MyPlainTestComponent>("MyPlainTestComponent");
+		world.registerComponentCodec<MyNamedTestComponent>(
+				"MyNamedTestComponent",
+				[](const MyNamedTestComponent &component, std::ostream &stream) {
+					writeBinary(stream, static_cast<uint32_t>(component.name.size()));
+					stream.write(component.name.data(), static_cast<std::streamsize>(component.name.size()));
+				},
+				[](std::istream &stream, MyNamedTestComponent &component) {
+					uint32_t length = 0;
+					readBinary(stream, length);
+					component.name.resize(length);
+					stream.read(component.name.data(), length);
+				});
+	};
+	auto server = std::make_shared<World>();
+	auto client = std::make_shared<World>();
+	registerCodecs(*server);
+	registerCodecs(*client);
+
+	auto entities = std::vector<Entity>();
+	for (int i = 0; i < 3; ++i) {
+		auto entity = server->createNewEntity().value();
+		server->addComponent<MyPlainTestComponent>(entity);
+		server->getComponent<MyPlainTestComponent>(entity).value()->id = i;
+		entities.push_back(entity);
+	}
+	server->addComponent<MyNamedTestComponent>(entities[1]);
+	server->getComponent<MyNamedTestComponent>(entities[1]).value()->name = "Named";
+
+	auto baseline = DiffBaseline();
+	auto entityMap = DiffEntityMap();
+	std::stringstream initialDiff;
+	REQUIRE(server->writeDiff(baseline, initialDiff));
+	REQUIRE(client->applyDiff(initialDiff, entityMap));
+	server->clearChangedRows();
+	REQUIRE(entityMap.size() == 3);
+	for (int i = 0; i < 3; ++i) {
+		auto localEntity = entityMap.getLocalEntity(entities[i]).value();
+		REQUIRE(client->getComponent<MyPlainTestComponent>(localEntity).value()->id == i);
+	}
+	REQUIRE(client->getComponent<MyNamedTestComponent>(entityMap.getLocalEntity(entities[1]).value()).value()->name == "Named");
+
+	SECTION("Write a diff without changes - Only the header is written") {
+		std::stringstream stream;
+		REQUIRE(server->writeDiff(baseline, stream));
+		REQUIRE(stream.str().size() == 2 * sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint32_t));
+		REQUIRE(client->applyDiff(stream, entityMap));
+	}
+
+	SECTION("Change a single member - Only the changed chunk is written and applied") {
+		server->getComponent<MyPlainTestComponent>(entities[2]).value()->y = 4.0f;
+		// Rows handed out without being modified are compared but not written.
+		server->getComponent<MyPlainTestComponent>(entities[0]);
+		server->getComponent<MyNamedTestComponent>(entities[1]);
+
+		std::stringstream stream;
+		REQUIRE(server->writeDiff(baseline, stream));
+		size_t blockSize = sizeof(uint32_t) + std::string("MyPlainTestComponent").size() + sizeof(uint32_t);
+		size_t entrySize = sizeof(uint64_t) + 1 + WORLD_DIFF_CHUNK_SIZE;
+		REQUIRE(stream.str().size() == 2 * sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint32_t) + blockSize + entrySize);
+
+		REQUIRE(client->applyDiff(stream, entityMap));
+		auto component = client->getComponent<MyPlainTestComponent>(entityMap.getLocalEntity(entities[2]).value()).value();
+		REQUIRE(component->y == 4.0f);
+		REQUIRE(component->id == 2);
+	}
+
+	SECTION("Change the structure - Entities and components are created and destroyed") {
+		auto createdEntity = server->createNewEntity().value();
+		server->addComponent<MyPlainTestComponent>(createdEntity);
+		server->getComponent<MyPlainTestComponent>(createdEntity).value()->x = 3.0f;
+		server->removeEntity(entities[0]);
+		server->removeComponent<MyPlainTestComponent>(entities[1]);
+		server->addComponent<MyNamedTestComponent>(entities[2]);
+		server->getComponent<MyNamedTestComponent>(entities[2]).value()->name = "Added";
+
+		std::stringstream stream;
+		REQUIRE(server->writeDiff(baseline, stream));
+		REQUIRE(client->applyDiff(stream, entityMap));
+		REQUIRE(entityMap.size() == 3);
+		REQUIRE_FALSE(entityMap.getLocalEntity(entities[0]).has_value());
+		REQUIRE(WorldFriendAccessor::getEntityCount(client) == 3);
+
+		auto namedEntity = entityMap.getLocalEntity(entities[1]).value();
+		REQUIRE_FALSE(client->getComponent<MyPlainTestComponent>(namedEntity).has_value());
+		REQUIRE(client->getComponent<MyNamedTestComponent>(namedEntity).value()->name == "Named");
+		auto extendedEntity = entityMap.getLocalEntity(entities[2]).value();
+		REQUIRE(client->getComponent<MyPlainTestComponent>(extendedEntity).value()->id == 2);
+		REQUIRE(client->getComponent<MyNamedTestComponent>(extendedEntity).value()->name == "Added");
+		REQUIRE(client->getComponent<MyPlainTestComponent>(entityMap.getLocalEntity(createdEntity).value()).value()->x == 3.0f);
+	}
+
+	SECTION("Recycle a destroyed index - The entity is destroyed and created again on the receiver") {
+		auto oldLocalEntity = entityMap.getLocalEntity(entities[0]).value();
+		client->addComponent<MyTestComponent>(oldLocalEntity);
+		auto removedCount = 0;
+		client->onRemove<MyPlainTestComponent>([&removedCount](std::span<const Entity> removedEntities) {
+			removedCount += static_cast<int>(removedEntities.size());
+		});
+
+		server->removeEntity(entities[0]);
+		auto recycledEntity = server->createNewEntity().value();
+		REQUIRE(recycledEntity == entities[0]);
+		server->addComponent<MyPlainTestComponent>(recycledEntity);
+		server->getComponent<MyPlainTestComponent>(recycledEntity).value()->id = 7;
+
+		std::stringstream stream;
+		REQUIRE(server->writeDiff(baseline, stream));
+		REQUIRE(client->applyDiff(stream, entityMap));
+		REQUIRE(removedCount == 1);
+		REQUIRE(entityMap.size() == 3);
+		REQUIRE(WorldFriendAccessor::getEntityCount(client) == 3);
+		auto newLocalEntity = entityMap.getLocalEntity(recycledEntity).value();
+		REQUIRE(client->getComponent<MyPlainTestComponent>(newLocalEntity).value()->id == 7);
+		REQUIRE_FALSE(client->getComponent<MyTestComponent>(newLocalEntity).has_value());
+	}
+
+	SECTION("Apply corrupt sizes - The diff is rejected without allocating for the sizes") {
+		auto writeHeader = [](std::ostream &stream) {
+			writeBinary(stream, WORLD_DIFF_MAGIC);
+			writeBinary(stream, WORLD_DIFF_VERSION);
+			writeBinary(stream, uint8_t(0));
+			writeBinary(stream, uint32_t(1));
+		};
+		std::stringstream longNameStream;
+		writeHeader(longNameStream);
+		writeBinary(longNameStream, std::numeric_limits<uint32_t>::max());
+		REQUIRE_FALSE(client->applyDiff(longNameStream, entityMap));
+
+		std::stringstream largeInstanceStream;
+		writeHeader(largeInstanceStream);
+		std::string name = "MyNamedTestComponent";
+		writeBinary(largeInstanceStream, static_cast<uint32_t>(name.size()));
+		largeInstanceStream.write(name.data(), static_cast<std::streamsize>(name.size()));
+		writeBinary(largeInstanceStream, uint32_t(1));
+		writeBinary(largeInstanceStream, static_cast<uint64_t>(entities[1]));
+		writeBinary(largeInstanceStream, std::numeric_limits<uint32_t>::max());
+		REQUIRE_FALSE(client->applyDiff(largeInstanceStream, entityMap));
+		REQUIRE(client->getComponent<MyNamedTestComponent>(entityMap.getLocalEntity(entities[1]).value()).value()->name == "Named");
+	}
+
+	SECTION("Reset the baseline - The whole world is written again") {
+		baseline.reset();
+		auto resyncedClient = std::make_shared<World>();
+		registerCodecs(*resyncedClient);
+		auto resyncedEntityMap = DiffEntityMap();
+		std::stringstream stream;
+		REQUIRE(server->writeDiff(baseline, stream));
+		REQUIRE(resyncedClient->applyDiff(stream, resyncedEntityMap));
+		REQUIRE(resyncedEntityMap.size() == 3);
+		REQUIRE(resyncedClient->getComponent<MyPlainTestComponent>(resyncedEntityMap.getLocalEntity(entities[1]).value()).value()->id == 1);
+	}
+}
+
+TEST_CASE("World - Render extraction") {
+	auto world = std::make_shared<World>();
+	world->registerComponentCodec<MyPlainTestComponent>("MyPlainTestComponent");
+	for (int i = 0; i < 8; ++i) {
+		auto entity = world->createNewEntity().value();
+		world->addComponent<MyPlainTestComponent>(entity);
+		world->getComponent<MyPlainTestComponent>(entity).value()->id = 8 - i;
+	}
+	auto extractionBuffer = ExtractionBuffer<MyPlainTestComponent>();
+	auto extractFrame = [&world, &extractionBuffer]() {
+		auto &list = extractionBuffer.getBackList();
+		world->readEachEnabled<MyPlainTestComponent>([&list](const MyPlainTestComponent &component) {
+			list.push_back(component);
+		});
+		std::sort(list.begin(), list.end(), [](const auto &a, const auto &b) { return a.id < b.id; });
+		extractionBuffer.publish();
+	};
+
+	SECTION("Extract a frame - The rows are copied without being marked as changed") {
+		auto baseline = DiffBaseline();
+		std::stringstream initialDiff;
+		REQUIRE(world->writeDiff(baseline, initialDiff));
+		world->clearChangedRows();
+
+		REQUIRE(extractionBuffer.read([](const auto &list) { REQUIRE(list.empty()); }) == 0);
+		extractFrame();
+		auto readFrameCount = extractionBuffer.read([](const std::vector<MyPlainTestComponent> &list) {
+			REQUIRE(list.size() == 8);
+			for (int i = 0; i < 8; ++i) {
+				REQUIRE(list[i].id == i + 1);
+			}
+		});
+		REQUIRE(readFrameCount == 1);
+
+		std::stringstream stream;
+		REQUIRE(world->writeDiff(baseline, stream));
+		REQUIRE(stream.str().size() == 2 * sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint32_t));
+	}
+
+	SECTION("Extract while another thread reads - Every read list belongs to a single frame") {
+		const uint64_t frameCount = 200;
+		auto producer = std::thread([&world, &extractionBuffer, &extractFrame, frameCount]() {
+			for (uint64_t frame = 1; frame <= frameCount; ++frame) {
+				world->forEachEnabled<MyPlainTestComponent>([frame](MyPlainTestComponent &component) {
+					component.x = static_cast<float>(frame);
+				});
+				extractFrame();
+				extractionBuffer.waitUntilPickedUp();
+			}
+		});
+
+		bool consistent = true;
+		auto readFrames = std::set<uint64_t>();
+		uint64_t readFrameCount = 0;
+		while (readFrameCount < frameCount) {
+			readFrameCount = extractionBuffer.read([&consistent](const std::vector<MyPlainTestComponent> &list) {
+				if (list.empty()) return;
+				consistent &= list.size() == 8;
+				for (const auto &component: list) {
+					consistent &= component.x == list.front().x;
+				}
+			});
+			if (readFrameCount > 0) readFrames.insert(readFrameCount);
+		}
+		producer.join();
+		REQUIRE(consistent);
+		// The producer never runs ahead of a frame the consumer has not picked up, so no frame is skipped.
+		REQUIRE(readFrames.size() == frameCount);
+		REQUIRE(extractionBuffer.getPublishedFrameCount() == frameCount);
+	}
+
+	SECTION("Close the buffer - The producer no longer waits for the consumer") {
+		extractFrame();
+		extractionBuffer.close();
+		REQUIRE_FALSE(extractionBuffer.waitUntilPickedUp());
+		extractFrame();
+		REQUIRE(extractionBuffer.getPublishedFrameCount() == 2);
+	}
+}
@@ -71,7 +71,7 @@ namespace Graphics {
 		renderSteps.push_back(renderStep);
 	}
 
-	void JarRenderer::AddMesh(Mesh& mesh) {
+	uint32_t JarRenderer::AddMesh(Mesh& mesh) {
 
 		const size_t vertexDataSize = mesh.getVertices().size() * sizeof(Vertex);
 
@@ -89,9 +89,36 @@ namespace Graphics {
 				SetUsageFlags(BufferUsage::IndexBuffer);
 		std::shared_ptr<JarBuffer> indexBuffer = indexBufferBuilder->Build(device);
 		meshes.emplace_back(mesh, vertexBuffer, indexBuffer);
+		return static_cast<uint32_t>(meshes.size() - 1);
 	}
 
 	void JarRenderer::Render() {
+		recordFrame([this](JarCommandBuffer* commandBuffer) {
+			for (auto& mesh: meshes) {
+				commandBuffer->BindVertexBuffer(mesh.getVertexBuffer());
+				commandBuffer->BindIndexBuffer(mesh.getIndexBuffer());
+				commandBuffer->DrawIndexed(mesh.getIndexLength());
+			}
+		});
+	}
+
+	void JarRenderer::Render(const std::vector<RenderItem>& renderList) {
+		recordFrame([this, &renderList](JarCommandBuffer* commandBuffer) {
+			std::optional<uint32_t> boundMeshId;
+			for (const auto& renderItem: renderList) {
+				if (renderItem.meshId >= meshes.size()) continue;
+				const auto& mesh = meshes[renderItem.meshId];
+				if (boundMeshId != renderItem.meshId) {
+					commandBuffer->BindVertexBuffer(mesh.getVertexBuffer());
+					commandBuffer->BindIndexBuffer(mesh.getIndexBuffer());
+					boundMeshId = renderItem.meshId;
+				}
+				commandBuffer->DrawIndexed(mesh.getIndexLength());
+			}
+		});
+	}
+
+	void JarRenderer::recordFrame(const std::function<void(JarCommandBuffer*)>& recordDrawCalls) {
 
 		Viewport viewport{};
 		viewport.x = 0;
@@ -126,12 +153,7 @@ namespace Graphics {
 			commandBuffer->BindPipeline(renderStep->GetPipeline(), frameCounter);
 			commandBuffer->BindDescriptors(renderStep->GetDescriptors());
 
-
-			for (auto& mesh: meshes) {
-				commandBuffer->BindVertexBuffer(mesh.getVertexBuffer());
-				commandBuffer->BindIndexBuffer(mesh.getIndexBuffer());
-				commandBuffer->DrawIndexed(mesh.getIndexLength());
-			}
+			recordDrawCalls(commandBuffer);
 
 			commandBuffer->EndRecording();
 		}
@@ -11,9 +11,12 @@
 #include <fstream>
 #include <utility>
 #include <vector>
+#include <functional>
+#include <optional>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "Mesh.hpp"
+#include "RenderItem.hpp"
 #include "Vertex.hpp"
 #include "JarRenderStep.hpp"
 #include "API/src/IRendererAPI/IRenderAPI.hpp"
@@ -66,12 +69,21 @@ namespace Graphics {
 
 			void ChangeResolution(uint32_t resX, uint32_t resY);
 
-			void AddMesh(Mesh& mesh);
+			/// Upload a mesh to the device.
+			/// \return The id render items refer to the mesh with.
+			uint32_t AddMesh(Mesh& mesh);
 
 			void AddRenderStep(std::unique_ptr<JarRenderStepDescriptor> renderStepBuilder);
 
+			/// Draw every mesh once.
 			void Render();
 
+			/// Draw the items of a render list in their order. The vertex and index buffers are only bound again when the
+			/// mesh changes, so lists sorted by RenderItem::GetSortKey need the least state changes. Items referring to an
+			/// unknown mesh are skipped. Per-entity transforms are not rendered: all items share the model-view-projection
+			/// of the frame until the command buffers can push per-draw data.
+			void Render(const std::vector<RenderItem>& renderList);
+
 			void Shutdown();
 
 		private:
@@ -99,6 +111,8 @@ namespace Graphics {
 
 			void prepareModelViewProjectionForFrame();
 
+			void recordFrame(const std::function<void(JarCommandBuffer*)>& recordDrawCalls);
+
 			static std::string readFile(const std::string& filename) {
 				std::ifstream file(filename, std::ios::ate | std::ios::binary);
 
@@ -0,0 +1,25 @@
+//
+// Created by Sebastian Borsch on 19.10.26.
+//
+
+#ifndef JAREP_RENDERITEM_HPP
+#define JAREP_RENDERITEM_HPP
+
+#include <cstdint>
+
+namespace Graphics {
+
+	/// A single draw call of a frame, packed so a whole render list can be copied and sorted without following pointers.
+	/// Items carry no transform: the renderer has no per-draw data yet, so every item is drawn with the
+	/// model-view-projection of the frame.
+	struct RenderItem {
+		/// The id returned by JarRenderer::AddMesh.
+		uint32_t meshId;
+		uint32_t materialId;
+
+		/// Order draws by material first and mesh second, so consecutive draws share as much bound state as possible.
+		[[nodiscard]] uint64_t GetSortKey() const { return (static_cast<uint64_t>(materialId) << 32) | meshId; }
+	};
+}
+
+#endif //JAREP_RENDERITEM_HPP